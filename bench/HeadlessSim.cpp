@@ -0,0 +1,127 @@
+// Loads a scene description (see SceneFile.h) and steps it as fast as it
+// can, with no window, GL or sound. Prints how long that took and a hash of
+// the final body state, so physics changes can be profiled and checked for
+// regressions on machines without a display. A snapshot (see Snapshot.h,
+// Scene.SaveSnapshot writes them too) can replace the scene's bodies before
+// stepping, and the final state can be saved to one
+//
+//	headlessSim scene.txt [steps] [--colored] [--nosleep] [--nowarmstart] [--load snap] [--save snap]
+
+#include "PhysicsWorld.h"
+#include "SceneFile.h"
+#include "Util.h"
+
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using SimClock = std::chrono::high_resolution_clock;
+
+// FNV-1a over the bits of every body's position, angle and velocities
+uint64_t HashBodies( const PhysicsWorld& world )
+{
+	uint64_t uHash = 14695981039346656037ull;
+	auto addFloat = [&uHash] ( float f )
+	{
+		uint32_t uBits;
+		memcpy( &uBits, &f, sizeof( uBits ) );
+		for ( int i = 0; i < 4; i++ )
+		{
+			uHash ^= ( uBits >> ( 8 * i ) ) & 0xFF;
+			uHash *= 1099511628211ull;
+		}
+	};
+
+	for ( size_t i = 0; i < world.GetNumRigidBodies(); i++ )
+	{
+		const RigidBody2D * pRB = world.GetRigidBody2D( i );
+		for ( float f : { pRB->GetCenter().x, pRB->GetCenter().y, pRB->GetTheta(), pRB->GetVel().x, pRB->GetVel().y, pRB->GetOmega() } )
+			addFloat( f );
+	}
+
+	return uHash;
+}
+
+int main( int argc, char ** argv )
+{
+	if ( argc < 2 )
+	{
+		std::cerr << "Usage: " << argv[0] << " scene.txt [steps] [--colored] [--nosleep] [--nowarmstart] [--load snap] [--save snap]" << std::endl;
+		return 1;
+	}
+
+	int nSteps( 1000 );
+	std::string strLoad, strSave;
+	PhysicsWorld world;
+	for ( int i = 2; i < argc; i++ )
+	{
+		if ( strcmp( argv[i], "--colored" ) == 0 )
+			world.SetSolverMode( Contact::Solver::EMode::Colored );
+		else if ( strcmp( argv[i], "--nosleep" ) == 0 )
+			world.SetAllowSleep( false );
+		else if ( strcmp( argv[i], "--nowarmstart" ) == 0 )
+			world.SetWarmStartFactor( 0 );
+		else if ( strcmp( argv[i], "--load" ) == 0 && i + 1 < argc )
+			strLoad = argv[++i];
+		else if ( strcmp( argv[i], "--save" ) == 0 && i + 1 < argc )
+			strSave = argv[++i];
+		else
+			nSteps = atoi( argv[i] );
+	}
+
+	if ( LoadSceneFile( argv[1], world ) < 0 )
+		return 1;
+
+	if ( strLoad.empty() == false )
+	{
+		std::vector<uint8_t> vData;
+		if ( ReadSnapshotFile( strLoad, vData ) == false )
+			return 1;
+
+		SnapshotReader reader( vData.data(), vData.size() );
+		if ( world.LoadSnapshot( reader ) == false )
+			return 1;
+	}
+
+	// Step, keeping track of how busy the steps were
+	size_t nTotalContacts( 0 ), nTotalPairs( 0 ), nTotalIterations( 0 );
+	double dIntegrateMS( 0 ), dBroadphaseMS( 0 ), dNarrowphaseMS( 0 ), dSolveMS( 0 );
+	auto tBegin = SimClock::now();
+	for ( int i = 0; i < nSteps; i++ )
+	{
+		world.Step();
+		const PhysicsWorld::Stats& stats = world.GetStats();
+		nTotalContacts += stats.nContacts;
+		nTotalPairs += stats.nBroadphasePairs;
+		nTotalIterations += stats.nSolverIterations;
+		dIntegrateMS += stats.fIntegrateMS;
+		dBroadphaseMS += stats.fBroadphaseMS;
+		dNarrowphaseMS += stats.fNarrowphaseMS;
+		dSolveMS += stats.fSolveMS;
+	}
+	const double dSeconds = std::chrono::duration<double>( SimClock::now() - tBegin ).count();
+
+	const double dSteps = std::max( nSteps, 1 );
+	std::cout << world.GetNumRigidBodies() << " bodies, " << nSteps << " steps of " << world.GetTimeStep() << "s in " << dSeconds << "s ("
+		<< nSteps / dSeconds << " steps/s, " << 1000. * dSeconds / dSteps << " ms/step)" << std::endl;
+	std::cout << "per step: " << nTotalPairs / dSteps << " pairs, " << nTotalContacts / dSteps << " contacts, "
+		<< nTotalIterations / dSteps << " solver iterations" << std::endl;
+	std::cout << "ms/step: " << dIntegrateMS / dSteps << " integrate, " << dBroadphaseMS / dSteps << " broadphase, "
+		<< dNarrowphaseMS / dSteps << " narrowphase, " << dSolveMS / dSteps << " solve" << std::endl;
+	std::cout << "kinetic energy " << world.GetStats().fKineticEnergy << std::endl;
+	std::cout << world.GetNumAwakeBodies() << " awake, " << world.GetNumSleepingBodies() << " asleep, state hash "
+		<< std::hex << HashBodies( world ) << std::dec << std::endl;
+
+	if ( strSave.empty() == false )
+	{
+		std::vector<uint8_t> vData;
+		SnapshotWriter writer( vData );
+		world.SaveSnapshot( writer );
+		if ( WriteSnapshotFile( strSave, vData ) == false )
+			return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+// Compares the separating axis OBB-OBB narrowphase (GetSpecContacts)
+// against the original feature walking routine (GetSpecContactsFeatureWalk):
+// both must produce the same contacts, and we want to know which is faster
+
+#include "RigidBody2D.h"
+#include "SweepAndPrune.h"
+#include "CollisionFunctions.h"
+#include "Glm_Util.h"
+#include "Util.h"
+
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using BenchClock = std::chrono::high_resolution_clock;
+
+// Boxes (every eighth one a static AABB) scattered over a square whose size sets how crowded it is
+std::vector<RigidBody2D> MakeBoxes( const int nBoxes, const float fDensity, const uint32_t uSeed )
+{
+	std::mt19937 rng( uSeed );
+	std::uniform_real_distribution<float> U( -1.f, 1.f ), S( 0.2f, 0.8f );
+	const float fExtent = sqrtf( nBoxes / fDensity );
+
+	std::vector<RigidBody2D> vBoxes;
+	for ( int i = 0; i < nBoxes; i++ )
+	{
+		vec2 v2Pos( U( rng ) * fExtent, U( rng ) * fExtent );
+		vec2 v2Vel( U( rng ) * 4.f, U( rng ) * 4.f );
+		vec2 v2Dim( S( rng ) * 2.f, S( rng ) * 2.f );
+		if ( i % 8 == 0 )
+			vBoxes.push_back( AABB::Create( vec2( 0 ), v2Pos, -1.f, 1.f, v2Dim / 2.f ) );
+		else
+			vBoxes.push_back( OBB::Create( v2Vel, v2Pos, 1.f, 1.f, v2Dim, U( rng ) * 3.14159f ) );
+		vBoxes.back().SetOmega( vBoxes.back().fMass > 0 ? U( rng ) : 0.f );
+	}
+
+	return vBoxes;
+}
+
+bool SameBits( float a, float b )
+{
+	return memcmp( &a, &b, sizeof( float ) ) == 0;
+}
+
+int main( int argc, char ** argv )
+{
+	const int nBoxes = argc > 1 ? atoi( argv[1] ) : 2000;
+	const int nReps = argc > 2 ? atoi( argv[2] ) : 50;
+
+	bool bAllMatched( true );
+	for ( float fDensity : { 0.1f, 0.4f, 1.f } )
+	{
+		std::vector<RigidBody2D> vBoxes = MakeBoxes( nBoxes, fDensity, 1 );
+		SweepAndPrune broadphase;
+		const std::vector<SweepAndPrune::Pair>& vBoxPairs = broadphase.FindPairs( vBoxes, kDefaultTimeStep );
+
+		// Compare contacts pair by pair
+		size_t nContacts( 0 ), nMismatched( 0 );
+		std::vector<Contact> vWalk, vSAT;
+		for ( const SweepAndPrune::Pair& pair : vBoxPairs )
+		{
+			OBB * pA = (OBB *) &vBoxes[pair.uIdxA];
+			OBB * pB = (OBB *) &vBoxes[pair.uIdxB];
+			vWalk.clear();
+			vSAT.clear();
+			GetSpecContactsFeatureWalk( pA, pB, vWalk, kDefaultTimeStep );
+			GetSpecContacts( pA, pB, vSAT, kDefaultTimeStep );
+
+			bool bMatch = vWalk.size() == vSAT.size();
+			for ( size_t i = 0; bMatch && i < vWalk.size(); i++ )
+			{
+				bMatch = vWalk[i].GetBodyA() == vSAT[i].GetBodyA() &&
+					vWalk[i].GetFeatureID() == vSAT[i].GetFeatureID() &&
+					SameBits( vWalk[i].GetDistance(), vSAT[i].GetDistance() ) &&
+					SameBits( vWalk[i].GetInertialDenom(), vSAT[i].GetInertialDenom() );
+			}
+
+			nContacts += vSAT.size();
+			if ( bMatch == false )
+				nMismatched++;
+		}
+		bAllMatched = bAllMatched && nMismatched == 0;
+
+		// Time both over every pair
+		auto timeRoutine = [&] ( uint32_t( *fnGetContacts )( OBB *, OBB *, std::vector<Contact>&, const float ) )
+		{
+			std::vector<Contact> vContacts;
+			auto tBegin = BenchClock::now();
+			for ( int r = 0; r < nReps; r++ )
+			{
+				vContacts.clear();
+				for ( const SweepAndPrune::Pair& pair : vBoxPairs )
+					fnGetContacts( (OBB *) &vBoxes[pair.uIdxA], (OBB *) &vBoxes[pair.uIdxB], vContacts, kDefaultTimeStep );
+			}
+			return std::chrono::duration<double, std::micro>( BenchClock::now() - tBegin ).count() / nReps;
+		};
+		const double dWalkUS = timeRoutine( GetSpecContactsFeatureWalk );
+		const double dSatUS = timeRoutine( GetSpecContacts );
+
+		std::cout << "density " << fDensity << ": " << vBoxPairs.size() << " pairs, " << nContacts << " contacts, "
+			<< nMismatched << " mismatched | feature walk " << dWalkUS << " us, SAT "
+			<< dSatUS << " us (" << dWalkUS / dSatUS << "x)" << std::endl;
+	}
+
+	return bAllMatched ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+// Steps a set of generated scenes (circles, boxes, mixed shapes, a dense
+// pile and a sparse gas) and reports how fast the physics ran. Results go
+// to stdout and to a JSON file, so builds can be compared for regressions
+//
+//	physicsBench [results.json] [--bodies N] [--steps N] [--colored] [--only name]
+
+#include "PhysicsWorld.h"
+#include "Util.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using BenchClock = std::chrono::high_resolution_clock;
+
+// Steps run before timing starts, so caches and pools are warm
+const int kWarmupSteps = 50;
+
+// What a generated scene looks like
+struct BenchScene
+{
+	std::string strName;
+	float fCircles;		// Fraction of bodies that are circles,
+	float fBoxes;		// axis aligned boxes (the rest are OBBs)
+	float fDensity;		// Fraction of the arena covered by bodies
+	float fSpeed;		// Largest initial speed
+};
+
+// What one run measured
+struct BenchResult
+{
+	std::string strName;
+	size_t nBodies;
+	int nSteps;
+	double dSeconds;
+	double dStepsPerSec;
+	double dPairsPerSec;
+	double dContactsPerStep;
+	double dIterationsPerStep;
+};
+
+// Lay the bodies out on a jittered grid inside four static walls, sized so that
+// they cover fDensity of the arena and don't overlap when the step starts
+void BuildScene( PhysicsWorld& world, const BenchScene& scene, const int nBodies, const uint32_t uSeed )
+{
+	std::mt19937 rng( uSeed );
+	std::uniform_real_distribution<float> U( 0.f, 1.f );
+
+	const int nSide = (int) ceil( sqrt( (float) nBodies ) );
+	const float fCell = 1.f;
+	const float fExtent = nSide * fCell;
+
+	// Walls, a little outside the grid
+	const float fWall = 1.f;
+	const float fHalf = 0.5f * fExtent + fWall;
+	for ( int i = 0; i < 4; i++ )
+	{
+		const bool bVertical = i < 2;
+		const float fSign = i % 2 ? 1.f : -1.f;
+		const glm::vec2 v2Pos = bVertical ? glm::vec2( fSign * fHalf, 0 ) : glm::vec2( 0, fSign * fHalf );
+		const float fLength = 2.f * fHalf + fWall;
+		world.AddRigidBody( RigidBody2D::EType::AABB, glm::vec2( 0 ), v2Pos, -1.f, 1.f,
+			{ { "w", bVertical ? fWall : fLength }, { "h", bVertical ? fLength : fWall } } );
+	}
+
+	// A circle of radius r covers pi r^2 of its cell, a box of side s covers s^2
+	const float fRadius = fCell * sqrtf( scene.fDensity / 3.14159f );
+	const float fSide = fCell * sqrtf( scene.fDensity );
+	for ( int i = 0; i < nBodies; i++ )
+	{
+		const glm::vec2 v2Pos( ( i % nSide + 0.5f ) * fCell - 0.5f * fExtent, ( i / nSide + 0.5f ) * fCell - 0.5f * fExtent );
+		const float fAngle = 6.28318f * U( rng );
+		const glm::vec2 v2Vel = scene.fSpeed * U( rng ) * glm::vec2( cosf( fAngle ), sinf( fAngle ) );
+		const float fScale = 0.7f + 0.3f * U( rng );
+
+		const float fType = U( rng );
+		if ( fType < scene.fCircles )
+			world.AddRigidBody( RigidBody2D::EType::Circle, v2Vel, v2Pos, 1.f, 1.f, { { "r", fScale * fRadius } } );
+		else if ( fType < scene.fCircles + scene.fBoxes )
+			world.AddRigidBody( RigidBody2D::EType::AABB, v2Vel, v2Pos, 1.f, 1.f, { { "w", fScale * fSide }, { "h", fScale * fSide } } );
+		else
+		{
+			// Keep the turned box inside its cell
+			const float fFit = fScale * std::min( fSide, fCell / 1.415f );
+			world.AddRigidBody( RigidBody2D::EType::OBB, v2Vel, v2Pos, 1.f, 1.f, { { "w", fFit }, { "h", fFit }, { "th", fAngle } } );
+		}
+	}
+}
+
+BenchResult RunScene( const BenchScene& scene, const int nBodies, const int nSteps, const bool bColored )
+{
+	PhysicsWorld world;
+	world.SetAllowSleep( false );
+	if ( bColored )
+		world.SetSolverMode( Contact::Solver::EMode::Colored );
+	BuildScene( world, scene, nBodies, 1 );
+
+	for ( int i = 0; i < kWarmupSteps; i++ )
+		world.Step();
+
+	size_t nTotalPairs( 0 ), nTotalContacts( 0 ), nTotalIterations( 0 );
+	auto tBegin = BenchClock::now();
+	for ( int i = 0; i < nSteps; i++ )
+	{
+		world.Step();
+		nTotalPairs += world.GetNumCandidatePairs();
+		nTotalContacts += world.GetContactBuffer().size();
+		nTotalIterations += world.GetSolverIterations();
+	}
+	const double dSeconds = std::chrono::duration<double>( BenchClock::now() - tBegin ).count();
+
+	BenchResult result;
+	result.strName = scene.strName;
+	result.nBodies = world.GetNumRigidBodies();
+	result.nSteps = nSteps;
+	result.dSeconds = dSeconds;
+	result.dStepsPerSec = nSteps / dSeconds;
+	result.dPairsPerSec = nTotalPairs / dSeconds;
+	result.dContactsPerStep = (double) nTotalContacts / nSteps;
+	result.dIterationsPerStep = (double) nTotalIterations / nSteps;
+	return result;
+}
+
+bool WriteJSON( const std::string& strFileName, const std::vector<BenchResult>& vResults, const bool bColored )
+{
+	std::ofstream ofsJSON( strFileName );
+	if ( ofsJSON.is_open() == false )
+		return false;
+
+	ofsJSON << "{\n\t\"solver\": \"" << ( bColored ? "colored" : "serial" ) << "\",\n\t\"timestep\": " << kDefaultTimeStep << ",\n\t\"scenes\": [\n";
+	for ( size_t i = 0; i < vResults.size(); i++ )
+	{
+		const BenchResult& r = vResults[i];
+		ofsJSON << "\t\t{ \"name\": \"" << r.strName << "\", \"bodies\": " << r.nBodies << ", \"steps\": " << r.nSteps
+			<< ", \"seconds\": " << r.dSeconds << ", \"steps_per_sec\": " << r.dStepsPerSec
+			<< ", \"pairs_per_sec\": " << r.dPairsPerSec << ", \"contacts_per_step\": " << r.dContactsPerStep
+			<< ", \"iterations_per_step\": " << r.dIterationsPerStep << " }" << ( i + 1 < vResults.size() ? "," : "" ) << "\n";
+	}
+	ofsJSON << "\t]\n}\n";
+	return ofsJSON.good();
+}
+
+int main( int argc, char ** argv )
+{
+	std::string strJSON( "physics_bench.json" ), strOnly;
+	int nBodies( 2000 ), nSteps( 500 );
+	bool bColored( false );
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( strcmp( argv[i], "--bodies" ) == 0 && i + 1 < argc )
+			nBodies = atoi( argv[++i] );
+		else if ( strcmp( argv[i], "--steps" ) == 0 && i + 1 < argc )
+			nSteps = atoi( argv[++i] );
+		else if ( strcmp( argv[i], "--only" ) == 0 && i + 1 < argc )
+			strOnly = argv[++i];
+		else if ( strcmp( argv[i], "--colored" ) == 0 )
+			bColored = true;
+		else
+			strJSON = argv[i];
+	}
+
+	if ( nBodies < 1 || nSteps < 1 )
+	{
+		std::cerr << "Error! Need at least one body and one step" << std::endl;
+		return 1;
+	}
+
+	const std::vector<BenchScene> vScenes = {
+		//	name			circles	boxes	density	speed
+		{ "circles",		1.f,	0.f,	0.3f,	3.f },
+		{ "obbs",			0.f,	0.f,	0.3f,	3.f },
+		{ "mixed",			0.34f,	0.33f,	0.3f,	3.f },
+		{ "dense_pile",		0.34f,	0.33f,	0.5f,	0.5f },
+		{ "sparse_gas",		1.f,	0.f,	0.02f,	10.f }
+	};
+
+	std::vector<BenchResult> vResults;
+	for ( const BenchScene& scene : vScenes )
+	{
+		if ( strOnly.empty() == false && strOnly != scene.strName )
+			continue;
+
+		vResults.push_back( RunScene( scene, nBodies, nSteps, bColored ) );
+		const BenchResult& r = vResults.back();
+		std::cout << r.strName << ": " << r.nBodies << " bodies, " << r.dStepsPerSec << " steps/s, "
+			<< r.dPairsPerSec << " pairs/s, " << r.dContactsPerStep << " contacts/step, "
+			<< r.dIterationsPerStep << " iterations/step" << std::endl;
+	}
+
+	if ( WriteJSON( strJSON, vResults, bColored ) == false )
+	{
+		std::cerr << "Error! Unable to write " << strJSON << std::endl;
+		return 1;
+	}
+
+	std::cout << "Results written to " << strJSON << std::endl;
+	return 0;
+}
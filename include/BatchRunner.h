@@ -0,0 +1,64 @@
+#pragma once
+
+#include "PhysicsWorld.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <map>
+#include <string>
+#include <memory>
+#include <stdint.h>
+
+// Steps many independent physics worlds at once, for offline parameter
+// sweeps. The worlds are spread across one shared pool, and each one solves
+// its contacts on the thread stepping it, so parallel loops never nest.
+// Results are packed world after world into flat arrays, so reading them
+// back costs one call no matter how many worlds there are
+class BatchRunner
+{
+public:
+	// If nThreads is 0 the hardware concurrency is used
+	BatchRunner( size_t nThreads = 0 );
+
+	// Add an empty world, returns its index
+	size_t AddWorld();
+
+	// Add a body to a world, returns the index of the body in that
+	// world or -1 if there's no such world or the body is invalid
+	int AddRigidBody( size_t worldIdx, RigidBody2D::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails );
+
+	// Add the bodies in a scene file (see SceneFile.h) to a world,
+	// returns the number added or -1 if that didn't work
+	int LoadSceneFile( size_t worldIdx, std::string strFileName );
+
+	PhysicsWorld * GetWorld( const size_t worldIdx );
+	size_t GetNumWorlds() const;
+
+	// Throw away every world and the last results
+	void Clear();
+
+	// The number of threads the worlds are stepped on
+	void SetNumThreads( size_t nThreads );
+	size_t GetNumThreads() const;
+
+	// Step every world nSteps times and gather the results below
+	void Run( uint32_t nSteps );
+
+	// Where each world's bodies start in the result arrays, with one
+	// extra entry at the end (so world i has offset[i+1] - offset[i] bodies)
+	const std::vector<uint32_t>& GetBodyOffsets() const;
+
+	// x, y and angle of every body after the last Run
+	const std::vector<float>& GetPositions() const;
+
+	// The number of colliding contacts each body was part of during the last Run
+	const std::vector<uint32_t>& GetCollisionCounts() const;
+
+private:
+	size_t m_nThreads;
+	std::unique_ptr<ThreadPool> m_pThreadPool;		// Made when a Run needs it
+	std::vector<std::unique_ptr<PhysicsWorld>> m_vWorlds;
+	std::vector<uint32_t> m_vBodyOffsets;
+	std::vector<float> m_vPositions;
+	std::vector<uint32_t> m_vCollisionCounts;
+};
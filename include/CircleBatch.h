@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RigidBody2D.h"
+#include "SweepAndPrune.h"
+
+#include <vector>
+
+// Batched circle-circle narrowphase. Candidate pairs are gathered into
+// structure of arrays form, then the speculative margin test, normals
+// and signed distances are computed four pairs at a time with SSE.
+// Pairs that survive are appended to the contact buffer
+class CircleBatch
+{
+public:
+	// Append speculative contacts for every circle-circle pair in vPairs,
+	// returns the number of pairs that were too far apart to produce one
+	size_t GetSpeculativeContacts( const RigidBody2D * pBodies, const std::vector<SweepAndPrune::Pair>& vPairs, std::vector<Contact>& vContacts, const float fDT ) noexcept;
+
+private:
+	// Inputs, one entry per pair (padded to the SIMD width)
+	std::vector<float> m_vDX;		// Center of B - center of A
+	std::vector<float> m_vDY;
+	std::vector<float> m_vRadSum;	// Sum of the radii
+	std::vector<float> m_vRelVX;	// Velocity of B - velocity of A (static bodies count as still)
+	std::vector<float> m_vRelVY;
+	std::vector<float> m_vSpin;		// |omega| * radius, summed over the dynamic bodies
+
+	// Outputs
+	std::vector<float> m_vNX;		// Contact normal (out of A)
+	std::vector<float> m_vNY;
+	std::vector<float> m_vDist;		// Signed distance between the circumferences
+	std::vector<int> m_vKeep;		// One bit per pair in each group of four, set if it makes a contact
+
+	void resize( const size_t nPairs );
+	void computeContacts( const float fDT );
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "RigidBody2D.h"
+#include "CollisionFunctions.h"
+
+#include <vector>
+#include <stdint.h>
+
+// Compile time dispatch from a pair of rigid body types to the
+// GetSpecContacts overload that handles them. The overloads take
+// the "smaller" type first (Circle < AABB < OBB), so pairs that
+// come in the other way around get swapped by the template
+
+// The primitive struct for each type
+template <RigidBody2D::EType eType> struct PrimitiveOf;
+template <> struct PrimitiveOf<RigidBody2D::EType::Circle> { using type = Circle; };
+template <> struct PrimitiveOf<RigidBody2D::EType::AABB> { using type = AABB; };
+template <> struct PrimitiveOf<RigidBody2D::EType::OBB> { using type = OBB; };
+
+// Cast a rigid body to the primitive its type says it is
+template <RigidBody2D::EType eType>
+typename PrimitiveOf<eType>::type * AsPrimitive( const RigidBody2D * pRB ) noexcept
+{
+	return static_cast<typename PrimitiveOf<eType>::type *>( const_cast<RigidBody2D *>( pRB ) );
+}
+
+// Calls the overload for eA and eB, swapping if eA comes after eB
+template <RigidBody2D::EType eA, RigidBody2D::EType eB, bool bSwap = ( eA > eB )>
+struct SpecContactDispatch
+{
+	static uint32_t Get( const RigidBody2D * pA, const RigidBody2D * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
+	{
+		return GetSpecContacts( AsPrimitive<eA>( pA ), AsPrimitive<eB>( pB ), vContacts, fDT );
+	}
+};
+
+template <RigidBody2D::EType eA, RigidBody2D::EType eB>
+struct SpecContactDispatch<eA, eB, true>
+{
+	static uint32_t Get( const RigidBody2D * pA, const RigidBody2D * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
+	{
+		return SpecContactDispatch<eB, eA>::Get( pB, pA, vContacts, fDT );
+	}
+};
+
+// Pairs involving EType::None have no overload. Scene::AddRigidBody
+// won't take those bodies, so this just makes no contacts
+inline uint32_t InvalidSpecContacts( const RigidBody2D *, const RigidBody2D *, std::vector<Contact>&, const float ) noexcept
+{
+	return 0;
+}
+
+using SpecContactFn = uint32_t ( * )( const RigidBody2D *, const RigidBody2D *, std::vector<Contact>&, const float );
+
+// Look up the function for a pair of types in a table built at compile time
+inline SpecContactFn GetSpecContactFn( const RigidBody2D::EType eA, const RigidBody2D::EType eB ) noexcept
+{
+	using EType = RigidBody2D::EType;
+	static constexpr SpecContactFn s_aTable[4][4] = {
+		{ InvalidSpecContacts, InvalidSpecContacts, InvalidSpecContacts, InvalidSpecContacts },
+		{ InvalidSpecContacts,
+			SpecContactDispatch<EType::Circle, EType::Circle>::Get,
+			SpecContactDispatch<EType::Circle, EType::AABB>::Get,
+			SpecContactDispatch<EType::Circle, EType::OBB>::Get },
+		{ InvalidSpecContacts,
+			SpecContactDispatch<EType::AABB, EType::Circle>::Get,
+			SpecContactDispatch<EType::AABB, EType::AABB>::Get,
+			SpecContactDispatch<EType::AABB, EType::OBB>::Get },
+		{ InvalidSpecContacts,
+			SpecContactDispatch<EType::OBB, EType::Circle>::Get,
+			SpecContactDispatch<EType::OBB, EType::AABB>::Get,
+			SpecContactDispatch<EType::OBB, EType::OBB>::Get }
+	};
+
+	return s_aTable[(int) eA][(int) eB];
+}
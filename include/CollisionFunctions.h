@@ -1,7 +1,8 @@
 #pragma once
 
-#include <list>
-#include "GL_Util.h"
+#include <vector>
+#include <stdint.h>
+#include "Glm_Util.h"
 
 // Forward all these types, it's all pointer based
 class Contact;
@@ -14,16 +15,28 @@ vec2 perp( vec2 v );	// returns (-v.y, v.x)
 vec2 maxComp( vec2 v );	// zeroes all but the biggest
 vec2 projectOnEdge( vec2 p, vec2 e0, vec2 e1 );
 
+// True if two bodies can't possibly touch during a step of fDT, in which
+// case the speculative contact functions return no contacts
+bool IsOutsideSpeculativeMargin( const RigidBody2D * pA, const RigidBody2D * pB, const float fDT ) noexcept;
 
-// Functions for getting speculative contacts
-std::list<Contact> GetSpecContacts( Circle * pA, Circle * pB );
-std::list<Contact> GetSpecContacts( Circle * pCirc, AABB * pAABB );
-std::list<Contact> GetSpecContacts( Circle * pCirc, OBB * pOBB );
+
+// Functions for getting speculative contacts, these append any
+// contacts they find to the arena and return how many they added.
+// fDT is the length of the step the contacts are for.
+// They run once per pair every step, so they don't throw; bodies
+// are validated once when they're added to the scene instead
+uint32_t GetSpecContacts( Circle * pA, Circle * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
+uint32_t GetSpecContacts( Circle * pCirc, AABB * pAABB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
+uint32_t GetSpecContacts( Circle * pCirc, OBB * pOBB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
 					  
-std::list<Contact> GetSpecContacts( AABB * pA, AABB * pB );
-std::list<Contact> GetSpecContacts( AABB * pAABB, OBB * pOBB );
+uint32_t GetSpecContacts( AABB * pA, AABB * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
+uint32_t GetSpecContacts( AABB * pAABB, OBB * pOBB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
 					  
-std::list<Contact> GetSpecContacts( OBB * pA, OBB * pB );
+uint32_t GetSpecContacts( OBB * pA, OBB * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
+
+// The original OBB-OBB routine (GetSpecContacts uses a SIMD separating axis version
+// that finds the same features), kept for comparison
+uint32_t GetSpecContactsFeatureWalk( OBB * pA, OBB * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -3,12 +3,14 @@
 // Forward for RigidBody2D
 class RigidBody2D;
 
-// Forward for debugging
-class Drawable;
+// Forward for the colored solver
+class ThreadPool;
 
 #include <glm/vec2.hpp>
 #include <list>
 #include <array>
+#include <vector>
+#include <stdint.h>
 
 // Contact for speculative contact collision detection
 class Contact
@@ -19,10 +21,17 @@ public:
 	Contact( RigidBody2D * pA, RigidBody2D * pB,		// Pointers to the pair
 			 const glm::vec2 posA, const glm::vec2 posB,// Positions of the pair
 			 const glm::vec2 nrm,						// Collision normal
-			 const float d );							// Distance
+			 const float d,								// Distance
+			 const uint32_t uFeatureID = 0 ) noexcept;	// Identifies the features that produced the contact
 
-	// Apply some collision impulse
-	void ApplyImpulse( float fMag );
+	// Apply some collision impulse, fBounce is the part of it that
+	// only applies to this step (restitution or pushing out of overlap)
+	void ApplyImpulse( float fMag, float fBounce = 0.f );
+
+	// Apply an impulse accumulated by this contact during the last step,
+	// if the pair is still approaching (bouncing contacts are left alone).
+	// fInvDT is 1 / the length of the step being solved
+	bool WarmStart( float fImpulse, const float fInvDT );
 
 	// Get the relative velocity of A and B
 	glm::vec2 GetVel_B() const;
@@ -36,6 +45,9 @@ public:
 	float GetAvgCoefRest() const;
 	float GetInertialDenom() const;
 	float GetCurImpulse() const;
+	float GetNormalImpulse() const;	// GetCurImpulse without the bounce, this is what gets warm started
+	uint32_t GetFeatureID() const;
+	glm::vec2 GetNormal() const;
 
 	const RigidBody2D * GetBodyA() const;
 	const RigidBody2D * GetBodyB() const;
@@ -45,15 +57,52 @@ public:
 	class Solver
 	{
 	public:
+		// How contacts are walked each iteration
+		enum class EMode
+		{
+			Serial,		// One after another, in order
+			Colored		// In batches that share no dynamic bodies, each spread across the thread pool
+		};
+
 		Solver();
 		Solver( uint32_t nIterations );
-		uint32_t Solve( std::list<Contact>& liContacts );
+
+		// Solve contacts, returns the number of collisions. If pnIterationsUsed
+		// is not null it receives the number of iterations it took to converge
+		uint32_t Solve( std::vector<Contact>& vContacts, uint32_t * pnIterationsUsed = nullptr ) const;
+
+		// Same, for a contiguous range of contacts (i.e. one island)
+		uint32_t Solve( Contact * pContacts, const size_t nContacts, uint32_t * pnIterationsUsed = nullptr ) const;
+
+		void SetMode( EMode eMode );
+		EMode GetMode() const;
+
+		// The pool colored batches are spread across (if null they run on the calling thread)
+		void SetThreadPool( ThreadPool * pThreadPool );
+
+		// The length of the step being solved (PhysicsWorld::SetTimeStep keeps this in sync)
+		void SetTimeStep( const float fDT );
+
 	private:
 		uint32_t m_nIterations;
+		EMode m_eMode;
+		ThreadPool * m_pThreadPool;
+		float m_fInvTimeStep;
+
+		// Scratch space for colored solves, so those aren't reentrant
+		mutable std::vector<uint64_t> m_vBodyColors;		// Colors used by each body
+		mutable std::vector<uint8_t> m_vContactColors;		// Color of each contact
+		mutable std::vector<uint32_t> m_vColorOffsets;		// Start of each color batch, plus the end
+		mutable std::vector<uint32_t> m_vColoredContacts;	// Contact indices sorted by color
+
+		// Returns true if the contact needed an impulse
+		static bool solveContact( Contact& c, const float fInvDT );
+
+		uint32_t solveColored( Contact * pContacts, const size_t nContacts, uint32_t * pnIterationsUsed ) const;
 	};
 
-	// Init a drawable, for debugging purposes
-	void InitDrawable( std::array<Drawable *, 2> drPtrArr ) const;
+	// The contact point on A (i = 0) or B (i = 1)
+	glm::vec2 GetPosition( int i ) const;
 
 	bool IsColliding() const;
 	class Solver;
@@ -82,6 +131,8 @@ private:
 	float m_fDist;			// The distance between the contact pair
 	float m_fInvMassI;		// 1 / the impulse mass
 	float m_fCurImpulse;	// The accumulated impulse value
+	float m_fBounceImpulse;	// The part of it that came from restitution or pushing out of overlap
+	uint32_t m_uFeatureID;	// Which features (faces, vertices) of the pair this came from
 	glm::vec2 m_v2Normal;	// The collision normal (out of A)
 
 	// internal contact vel function
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Contact.h"
+#include "RigidBody2D.h"
+#include "Snapshot.h"
+
+#include <vector>
+#include <stdint.h>
+
+// Remembers the impulse each contact accumulated during the last step,
+// keyed on the indices of the two bodies and the contact's feature ID.
+// Contacts that persist into the next step start with that impulse
+// already applied (warm starting), so the solver converges sooner
+class ContactCache
+{
+public:
+	ContactCache();
+
+	// Apply last step's impulses to matching contacts, returns the number of contacts warm started.
+	// pBodies is the start of the array the contacts' body pointers point into, fInvDT is 1 / the step length
+	size_t WarmStart( std::vector<Contact>& vContacts, const RigidBody2D * pBodies, const float fInvDT ) const;
+
+	// Replace the cache contents with the impulses accumulated by this step's contacts, less restitution
+	void Store( const std::vector<Contact>& vContacts, const RigidBody2D * pBodies );
+
+	void Clear();
+	size_t GetSize() const;
+
+	// Copy the entries out to / back in from a snapshot. Loading
+	// fails and leaves the cache alone if the entries are damaged
+	void SaveSnapshot( SnapshotWriter& writer ) const;
+	bool LoadSnapshot( SnapshotReader& reader );
+
+	// Scale applied to cached impulses when warm starting (0 disables it)
+	void SetWarmStartFactor( const float fFactor );
+	float GetWarmStartFactor() const;
+
+	// The key for a contact, built from body indices and the feature ID
+	static uint64_t GetKey( const Contact& c, const RigidBody2D * pBodies );
+
+private:
+	struct Entry
+	{
+		uint64_t uKey;
+		float fImpulse;
+	};
+
+	float m_fWarmStartFactor;
+	std::vector<Entry> m_vEntries;	// Sorted by key
+};
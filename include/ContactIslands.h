@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Contact.h"
+#include "RigidBody2D.h"
+
+#include <vector>
+#include <stdint.h>
+
+// Splits the contact graph into islands: groups of dynamic bodies
+// connected through contacts. Static bodies don't join the islands
+// they touch, so two piles resting on the same wall stay independent.
+// Islands share no dynamic bodies and can be solved concurrently
+class ContactIslands
+{
+public:
+	// Find islands and reorder vContacts so each island's contacts are contiguous,
+	// largest island first. pBodies is the start of the array the contacts' body
+	// pointers point into. Returns the number of islands
+	size_t Build( std::vector<Contact>& vContacts, const RigidBody2D * pBodies, const size_t nBodies );
+
+	size_t GetNumIslands() const;
+
+	// The range of island i within the reordered contacts
+	size_t GetIslandBegin( const size_t i ) const;
+	size_t GetIslandSize( const size_t i ) const;
+
+	// The island a body ended up in, or -1 if it's static or had no contacts
+	int GetBodyIsland( const size_t rbIdx ) const;
+
+private:
+	std::vector<uint32_t> m_vParent;		// Union-find forest over body indices
+	std::vector<int> m_vRootIsland;			// Unsorted island of each root body
+	std::vector<int> m_vBodyIsland;			// Sorted island of each body
+	std::vector<uint32_t> m_vContactIsland;	// Island of each contact
+	std::vector<uint32_t> m_vIslandOffsets;	// Start of each island, plus the end
+	std::vector<Contact> m_vScratch;		// Reordering buffer, keeps its storage
+
+	uint32_t find( uint32_t uIdx );
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+// The glm forwards and printing functions, without any OpenGL or SDL,
+// so the physics code can use them on machines without a display
+
+// glm is important to me
+#include <glm/fwd.hpp>
+using glm::vec2;
+using glm::vec3;
+using glm::vec4;
+using glm::fquat;
+using glm::mat4;
+using glm::mat3;
+
+// As are these printing functions
+#include <iostream>
+std::ostream& operator<<( std::ostream& os, const vec2& vec );
+std::ostream& operator<<( std::ostream& os, const vec3& vec );
+std::ostream& operator<<( std::ostream& os, const vec4& vec );
+std::ostream& operator<<( std::ostream& os, const mat4& mat );
+std::ostream& operator<<( std::ostream& os, const fquat& quat );
@@ -8,5 +8,6 @@ bool ExposeCamera();
 bool ExposeDrawable();
 bool ExposeRigidBody2D();
 bool ExposeContact();
+bool ExposeBatchRunner();
 
 bool ExposeAll();
\ No newline at end of file
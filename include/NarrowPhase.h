@@ -0,0 +1,35 @@
+#pragma once
+
+#include "RigidBody2D.h"
+#include "SweepAndPrune.h"
+#include "CircleBatch.h"
+
+#include <array>
+#include <vector>
+#include <stdint.h>
+
+// Buckets broadphase pairs by the types of their bodies, so that each
+// bucket can be run through one loop that always calls the same
+// GetSpecContacts overload instead of dispatching pair by pair
+class NarrowPhase
+{
+public:
+	// Empty the buckets (they keep their storage)
+	void Clear();
+
+	// Put a pair in its bucket, ordered so the body of the "smaller" type comes first
+	void AddPair( const RigidBody2D * pBodies, uint32_t uIdxA, uint32_t uIdxB );
+
+	// Append speculative contacts for every bucketed pair to vContacts, returns
+	// the number of pairs that were too far apart to produce any
+	size_t GetSpeculativeContacts( const RigidBody2D * pBodies, std::vector<Contact>& vContacts, const float fDT ) noexcept;
+
+	size_t GetNumPairs() const;
+
+private:
+	// One bucket per ordered type combination, indexed by 4 * eA + eB
+	std::array<std::vector<SweepAndPrune::Pair>, 16> m_avBuckets;
+
+	// Circle-circle pairs are the most common, so they get a SIMD kernel
+	CircleBatch m_CircleBatch;
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "RigidBody2D.h"
+#include "Contact.h"
+#include "SweepAndPrune.h"
+#include "NarrowPhase.h"
+#include "RigidBodyStore.h"
+#include "ContactCache.h"
+#include "ContactIslands.h"
+#include "ThreadPool.h"
+#include "Snapshot.h"
+#include "SpatialQuery.h"
+
+#include <vector>
+#include <list>
+#include <map>
+#include <string>
+#include <memory>
+
+// The rigid body simulation, without any windowing, drawing or sound.
+// The Scene owns one of these, and it can be stepped on its own
+// (see bench/HeadlessSim.cpp) where there's no display
+class PhysicsWorld
+{
+public:
+	// What happened during the last step
+	struct Stats
+	{
+		uint32_t nSubsteps;			// Steps these cover, 1 unless they're a total (see Add)
+		size_t nBroadphasePairs;	// Pairs whose padded bounds overlapped
+		size_t nContacts;			// Speculative contacts the narrowphase made
+		size_t nCollidingContacts;	// Contacts the solver had to push on
+		uint32_t nSolverImpulses;	// Impulses applied, summed over every iteration
+		uint32_t nSolverIterations;	// Iterations the solve took (the slowest island's)
+		float fKineticEnergy;		// Of the dynamic bodies, once the step is done
+		float fIntegrateMS;			// Time spent in each phase, in milliseconds
+		float fBroadphaseMS;
+		float fNarrowphaseMS;
+		float fSolveMS;				// Warm starting, islands, solving and caching impulses
+
+		Stats() :
+			nSubsteps( 0 ),
+			nBroadphasePairs( 0 ),
+			nContacts( 0 ),
+			nCollidingContacts( 0 ),
+			nSolverImpulses( 0 ),
+			nSolverIterations( 0 ),
+			fKineticEnergy( 0 ),
+			fIntegrateMS( 0 ),
+			fBroadphaseMS( 0 ),
+			fNarrowphaseMS( 0 ),
+			fSolveMS( 0 )
+		{}
+
+		// Add another step's stats to these. Counts and timings are summed,
+		// iterations are the most any step took and the energy is the latest
+		void Add( const Stats& step );
+	};
+
+	// A colliding contact from the last step, packed so the whole
+	// buffer can be handed to scripts as raw memory (see Scene)
+	struct CollisionEvent
+	{
+		int32_t iIdA;			// EntComponent IDs of the two bodies
+		int32_t iIdB;
+		float fImpulse;			// Accumulated along the normal
+		glm::vec2 v2Normal;		// Out of A
+		glm::vec2 v2Point;		// Halfway between the contact points
+	};
+
+	// Contacts are solved on a pool of nThreads (0 uses the hardware
+	// concurrency, 1 keeps everything on the thread calling Step)
+	explicit PhysicsWorld( size_t nThreads = 0 );
+
+	// Advance the simulation by exactly one fixed step
+	void Step();
+
+	// Returns the index of the new body, or -1 if the details are missing or invalid.
+	// Besides the shape, the details can hold "category" and "mask" collision
+	// layers (see RigidBody2D::ShouldCollide); as floats these only reach the
+	// low 24 bits, SetCollisionFilter can set all of them
+	int AddRigidBody( RigidBody2D::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails );
+
+	const RigidBody2D * GetRigidBody2D( const size_t rbIdx ) const;
+	size_t GetNumRigidBodies() const;
+
+	// Filled in by every step
+	const Stats& GetStats() const;
+
+	// The contacts found during the last step
+	std::list<const Contact *> GetContacts() const;
+	const std::vector<Contact>& GetContactBuffer() const;
+
+	// The contacts from the last step that needed an impulse
+	const std::vector<CollisionEvent>& GetCollisionEvents() const;
+
+	// The number of pairs the broadphase handed to the narrowphase last step
+	size_t GetNumCandidatePairs() const;
+
+	// The number of those pairs that were too far apart to produce a contact
+	size_t GetNumCulledContacts() const;
+
+	// The number of iterations the contact solver needed last step
+	uint32_t GetSolverIterations() const;
+
+	// The number of independent contact islands solved last step
+	size_t GetNumIslands() const;
+
+	// Serial solves islands concurrently, Colored solves all contacts in parallel batches
+	void SetSolverMode( Contact::Solver::EMode eMode );
+	Contact::Solver::EMode GetSolverMode() const;
+
+	// Bodies that come to rest are put to sleep, and woken when an awake body touches them
+	void SetAllowSleep( bool bAllowSleep );
+	bool GetAllowSleep() const;
+
+	// Wake a sleeping body, returns false if there's no such body
+	bool WakeRigidBody( const size_t rbIdx );
+
+	// Set the collision layers of a body, returns false if there's no such body.
+	// Pairs whose layers don't collide are dropped by the broadphase. Changing
+	// them wakes the body and anything asleep against it
+	bool SetCollisionFilter( const size_t rbIdx, const uint32_t uCategory, const uint32_t uMask );
+	void WakeAll();
+
+	// The number of dynamic bodies that are awake / asleep
+	size_t GetNumAwakeBodies() const;
+	size_t GetNumSleepingBodies() const;
+
+	// The length of a fixed step, each world has its own. This can change
+	// between steps, and returns false if fDT isn't a positive number
+	bool SetTimeStep( float fDT );
+	float GetTimeStep() const;
+	float GetInvTimeStep() const;
+
+	// A body's transform blended between the last two steps (fAlpha of 0 is
+	// where it was before the last step, 1 is where it is now)
+	quatvec GetInterpolatedQuatVec( const size_t rbIdx, const float fAlpha ) const;
+
+	// Scale applied to last step's impulses when warm starting contacts (0 disables it)
+	void SetWarmStartFactor( float fFactor );
+	float GetWarmStartFactor() const;
+
+	// Copy the bodies out to something batched queries can be run against from
+	// any thread, while this keeps stepping (see SpatialQuery.h)
+	std::shared_ptr<const SpatialQuery> MakeSpatialQuery() const;
+
+	// A physics section that has been read out of a snapshot and checked
+	struct SnapshotState
+	{
+		float fTimeStep;
+		std::vector<RigidBody2D> vRigidBodies;
+		ContactCache contactCache;
+
+		SnapshotState() : fTimeStep( 0 ) {}
+	};
+
+	// Copy the bodies, the contact cache and the time step out to a snapshot
+	// (see Snapshot.h), or replace them with the ones in a snapshot. Loading
+	// fails and leaves the world alone if the snapshot is from a different
+	// build, is damaged or holds a body that wouldn't pass AddRigidBody.
+	// Loading is ReadSnapshot then ApplySnapshot, callers with more than
+	// one section to load can read them all before applying any
+	void SaveSnapshot( SnapshotWriter& writer ) const;
+	bool LoadSnapshot( SnapshotReader& reader );
+	bool ReadSnapshot( SnapshotReader& reader, SnapshotState& state ) const;
+	void ApplySnapshot( SnapshotState& state );
+
+private:
+	bool m_bAllowSleep;
+	float m_fTimeStep;		// Length of a step
+	float m_fInvTimeStep;	// and its inverse, kept in sync by SetTimeStep
+	size_t m_uNumCulledContacts;
+	Stats m_Stats;
+	SweepAndPrune m_Broadphase;
+	NarrowPhase m_NarrowPhase;
+	std::vector<Contact> m_vSpeculativeContacts;	// Cleared each step, but keeps its storage
+	std::vector<CollisionEvent> m_vCollisionEvents;	// Same
+	Contact::Solver m_ContactSolver;
+	ContactCache m_ContactCache;
+	ContactIslands m_ContactIslands;
+	std::vector<uint32_t> m_vIslandIterations;	// Iterations each island took
+	std::vector<uint32_t> m_vIslandImpulses;	// Impulses each island applied
+	std::vector<float> m_vIslandSleepTime;		// Shortest sleep time in each island
+	std::unique_ptr<ThreadPool> m_pThreadPool;	// Islands are solved on this
+	std::vector<RigidBody2D> m_vRigidBodies;	// Views of the state in m_RigidBodyStore
+	RigidBodyStore m_RigidBodyStore;
+	std::vector<glm::vec2> m_vPrevCenters;	// Body transforms before the last step
+	std::vector<float> m_vPrevThetas;
+
+	// Wake sleeping bodies that an awake body is about to touch
+	void wakeTouchedBodies( const std::vector<SweepAndPrune::Pair>& vPairs );
+
+	// Wake a body and the sleeping bodies resting against it
+	void wakeIsland( const size_t rbIdx );
+
+	// Put islands that have been at rest long enough to sleep
+	void updateSleep( const float fDT );
+
+	// Remember where the bodies are before they move
+	void storePrevTransforms();
+
+	// Sum up the kinetic energy for the stats
+	void updateEnergy();
+};
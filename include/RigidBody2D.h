@@ -22,38 +22,113 @@ struct RigidBody2D : public EntComponent
 
 	EType eType;		// Primitive type
 	float fMass;		// Mass
+	float fInvMass;		// 1 / mass, 0 for static bodies
+	float fInvInertia;	// 1 / moment of inertia, 0 for static bodies
 	float fElast;		// Elasticity
-	float fTheta;		// Rotation angle
-	float fOmega;		// Angular velocity
-	glm::vec2 v2Vel;	// Velocity
-	glm::vec2 v2Center;	// Center position
+	bool bAsleep;		// Sleeping bodies aren't integrated or solved
+	float fSleepTime;	// How long the body has been slow enough to sleep
+	uint32_t uCategory;	// Collision layers the body is in,
+	uint32_t uMask;		// and the layers it collides with (see ShouldCollide)
 
 	// The big union
 	union
 	{
-		struct { glm::vec2 v2HalfDim; } boxData;
+		struct
+		{
+			glm::vec2 v2HalfDim;
+			glm::vec2 av2Verts[4];		// World space corners, see UpdateBoxGeometry
+			glm::vec2 av2Normals[4];	// World space face normals
+			glm::mat2 m2Rot;			// Rotation matrix
+		} boxData;
 		struct { float fRadius; } circData;
 	};
 
+	// What's wrong with a body, if anything. Bodies are checked once when
+	// they're added to a scene, so the step itself never has to
+	enum class EStatus : int
+	{
+		Valid,
+		BadType,	// EType::None, or not a type at all
+		NotFinite,	// NaN or infinity somewhere in the state
+		ZeroMass,	// Static bodies use a negative mass, not zero
+		BadShape	// Radius or half dimensions aren't positive
+	};
+
 	// Default constructor
 	RigidBody2D();
 
+	// Center position, velocity, rotation angle and angular velocity. A body in a
+	// PhysicsWorld is a view of these, they live in the world's RigidBodyStore
+	// (which integrates them in place). A body on its own keeps them itself
+	const glm::vec2& GetCenter() const { return *m_State.pCenter; }
+	const glm::vec2& GetVel() const { return *m_State.pVel; }
+	float GetTheta() const { return *m_State.pTheta; }
+	float GetOmega() const { return *m_State.pOmega; }
+	void SetCenter( const glm::vec2 v2Center ) { *m_State.pCenter = v2Center; }
+	void SetVel( const glm::vec2 v2Vel ) { *m_State.pVel = v2Vel; }
+	void SetTheta( const float fTheta ) { *m_State.pTheta = fTheta; }
+	void SetOmega( const float fOmega ) { *m_State.pOmega = fOmega; }
+
 	// Various gets
 	glm::vec2 GetMomentum() const;
 	float GetKineticEnergy() const;
 	quatvec GetQuatVec() const;
 	glm::mat2 GetRotMat() const;
-	float GetInertia() const;
+	float GetInertia() const noexcept;
+
+	// Recompute the cached inverse mass and inertia, must be
+	// called whenever the mass or shape of the body changes
+	void UpdateInverseMass();
+
+	// Recompute the cached world space corners, normals and rotation of a
+	// box, must be called whenever a box moves or turns. The narrowphase
+	// only reads these, so it never has to touch cos / sin
+	void UpdateBoxGeometry();
+	// Stop the body and put it to sleep, or wake it back up
+	void Sleep();
+	void Wake();
+
+	EStatus Validate() const noexcept;
+
+	// Two bodies only collide if each one's category is in the other's mask
+	static bool ShouldCollide( const RigidBody2D& rbA, const RigidBody2D& rbB ) noexcept;
+
+	glm::vec2 GetBoundingHalfDim() const noexcept;
+	float GetBoundingRadius() const noexcept;
 	void EulerAdvance( float fDT );
 
-	// Until we get rid of this dumb list pattern. This is handled internally via a switch
-	static std::list<Contact> GetSpeculativeContacts( const RigidBody2D * pA, const RigidBody2D * pB );
+	// Append speculative contacts between two bodies to vContacts, returns the number added.
+	// The overload is picked from a table built at compile time (see CollisionDispatch.h)
+	static uint32_t GetSpeculativeContacts( const RigidBody2D * pA, const RigidBody2D * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept;
 
 	// Interesting constructor is protected, called
 	// by class static methods from child classes (?)
 protected:
 	RigidBody2D( glm::vec2 vel, glm::vec2 c, float mass, float elasticity, float th = 0.f );
 	static RigidBody2D Create( glm::vec2 vel, glm::vec2 c, float mass, float elasticity, float th = 0.f );
+
+private:
+	friend class RigidBodyStore;
+
+	// Where the state is, and the body's own copy of it. Copying a body
+	// copies the values and points the copy at its own, so a copy taken
+	// from a world (for a query or a snapshot) doesn't change with it
+	struct State
+	{
+		glm::vec2 * pCenter;
+		glm::vec2 * pVel;
+		float * pTheta;
+		float * pOmega;
+		glm::vec2 v2Center;
+		glm::vec2 v2Vel;
+		float fTheta;
+		float fOmega;
+
+		State( const glm::vec2 c, const glm::vec2 vel, const float th );
+		State( const State& other );
+		State& operator=( const State& other );
+		void pointAtSelf();
+	} m_State;
 };
 
 // I'm not really sure about this...
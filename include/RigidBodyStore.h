@@ -0,0 +1,63 @@
+#pragma once
+
+#include "RigidBody2D.h"
+
+#include <vector>
+#include <stdint.h>
+
+// Structure of arrays store that owns the state of every body in a world.
+// Positions, velocities, angles and angular velocities live here and the
+// world's RigidBody2Ds are views of them (see RigidBody2D::GetCenter), so
+// the narrowphase, solver and scripts read and write the arrays through the
+// bodies, and integration is a SIMD kernel with nothing to copy around
+class RigidBodyStore
+{
+public:
+	RigidBodyStore();
+
+	// Take over the state of the body at the back of vRigidBodies, which has just
+	// been added. If that moved the bodies or these arrays, all of them are pointed
+	// at their state again
+	void Add( std::vector<RigidBody2D>& vRigidBodies );
+
+	// Replace everything with the state of vRigidBodies, and point them at it
+	void Bind( std::vector<RigidBody2D>& vRigidBodies );
+
+	// Advance positions and angles by fDT; static bodies (zero inverse mass)
+	// and bodies that don't rotate are masked out. Sleeping bodies have
+	// no velocity (see RigidBody2D::Sleep), so they stay put anyway
+	void Integrate( const float fDT );
+
+	size_t GetCount() const;
+
+	// Indices of the boxes, whose cached geometry has to follow the state
+	const std::vector<uint32_t>& GetBoxIndices() const;
+
+	// Accessors for the body at idx
+	glm::vec2 GetPosition( const size_t idx ) const;
+	glm::vec2 GetVelocity( const size_t idx ) const;
+	float GetTheta( const size_t idx ) const;
+	float GetOmega( const size_t idx ) const;
+	float GetInvMass( const size_t idx ) const;
+	float GetInvInertia( const size_t idx ) const;
+
+private:
+	size_t m_uCount;						// The number of bodies (arrays are padded past this)
+	std::vector<glm::vec2> m_vCenter;		// Center position
+	std::vector<glm::vec2> m_vVel;			// Velocity
+	std::vector<float> m_vTheta;			// Rotation angle
+	std::vector<float> m_vOmega;			// Angular velocity
+	std::vector<float> m_vInvMass;			// 1 / mass, 0 for static bodies
+	std::vector<float> m_vInvInertia;		// 1 / inertia, 0 for static bodies
+	std::vector<float> m_vRotates;			// 1 if integration changes the angle, else 0
+	std::vector<uint32_t> m_vBoxIndices;	// Bodies that are AABBs or OBBs
+
+	// Grow the arrays to hold uCount bodies, padding is zero (and therefore masked out)
+	void resize( const size_t uCount );
+
+	// Copy a body's state into slot idx and point the body at it
+	void store( RigidBody2D& rb, const size_t idx );
+
+	// Point a body at slot idx, which already holds its state
+	void bind( RigidBody2D& rb, const size_t idx );
+};
@@ -1,13 +1,16 @@
 #pragma once
 
-#include "RigidBody2D.h"
-#include "Contact.h"
+#include "PhysicsWorld.h"
+#include "BatchRunner.h"
+#include "SpatialQueryCache.h"
 #include "SoundManager.h"
 #include "Camera.h"
 #include "Shader.h"
 #include "Drawable.h"
+#include "Util.h"
 
 #include <vector>
+#include <memory>
 
 #include <SDL.h>
 
@@ -18,8 +21,18 @@ public:
 	~Scene();
 
 	void Draw();
+
+	// Run as many fixed steps as the wall time since the last call
+	// needs (up to the substep cap), the remainder carries over
 	void Update();
 
+	// Advance the simulation by exactly one fixed step
+	void Step();
+
+	// The simulation itself, everything but windowing, drawing and sound
+	PhysicsWorld * GetPhysicsWorld();
+	const PhysicsWorld * GetPhysicsWorld() const;
+
 	void SetQuitFlag( bool bQuit );
 	bool GetQuitFlag() const;
 
@@ -32,6 +45,7 @@ public:
 	const Shader * GetShaderPtr() const;
 	const Camera * GetCameraPtr() const;
 	const SoundManager * GetSoundManagerPtr() const;
+	const BatchRunner * GetBatchRunnerPtr() const;
 	const Drawable * GetDrawable( const size_t drIdx ) const;
 	const RigidBody2D * GetRigidBody2D( const size_t rbIdx ) const;
 
@@ -41,9 +55,128 @@ public:
 	
 	int AddRigidBody( RigidBody2D::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails );
 
+	// A drawable bound to a rigid body is moved to the body's interpolated
+	// transform at the end of every Update, or whenever SyncDrawables is
+	// called. Binding returns false if either index is out of range, and
+	// rebinding a drawable replaces its old binding
+	bool BindDrawable( const size_t rbIdx, const size_t drIdx );
+	bool UnbindDrawable( const size_t drIdx );
+	void ClearDrawableBindings();
+	void SyncDrawables();
+
 	std::list<const Contact *> GetContacts() const;
 
+	// Every contact that needed an impulse during the steps the last Update
+	// ran (Step adds to these, Update starts them over). Scripts get a copy
+	// of these as one bytes object, packed as CollisionEventFormat
+	const std::vector<PhysicsWorld::CollisionEvent>& GetCollisionEvents() const;
+	void ClearCollisionEvents();
+
+	// Collisions between bodies with non negative IDs (see EntComponent) are
+	// counted per ID by every step, until the counts are reset. IDs are used
+	// as indices, so they should be small and dense like the ones scripts use;
+	// IDs of 65536 and up aren't counted
+	void ResetCollisionCounts();
+	uint32_t GetCollisionCount( const int iID ) const;
+	std::vector<uint32_t> GetCollisionCounts() const;
+
+	// The ID with the most collisions since the last reset (the lowest
+	// one if there's a tie), or -1 if nothing has been counted since the last reset
+	int GetMostCollidedID() const;
+
+	// Batched queries against the bodies as they were at the end of the last Update
+	// (or RefreshSpatialQuery). Only a pointer swap is locked, so these can be run
+	// on a worker thread while the main thread steps and draws. Queries come in as
+	// flat lists of floats: points are x, y; boxes are min x, min y, max x, max y;
+	// rays are origin x, y, direction x, y and how far to look. Only bodies whose
+	// category is in uMask are hit. Scripts get the hits as bytes packed as
+	// QueryHitFormat (see SpatialQuery::Hit)
+	std::vector<SpatialQuery::Hit> QueryPoints( std::vector<float> vCoords, uint32_t uMask ) const;
+	std::vector<SpatialQuery::Hit> QueryBoxes( std::vector<float> vCoords, uint32_t uMask ) const;
+	std::vector<SpatialQuery::Hit> QueryRays( std::vector<float> vCoords, uint32_t uMask ) const;
+
+	// The copy the queries above run against, which stays valid for as long as it's
+	// held. Update only takes a new one if something changed and the last one was
+	// asked for (or there isn't one yet); if it wasn't, the old one is kept, so the
+	// first query after a quiet spell sees the bodies where that copy left them and
+	// the next Update catches up. RefreshSpatialQuery takes one right away
+	std::shared_ptr<const SpatialQuery> GetSpatialQuery() const;
+	void RefreshSpatialQuery();
+
+	// The number of pairs the broadphase handed to the narrowphase last step
+	size_t GetNumCandidatePairs() const;
+
+	// The number of those pairs that were too far apart to produce a contact
+	size_t GetNumCulledContacts() const;
+
+	// The number of iterations the contact solver needed last step
+	uint32_t GetSolverIterations() const;
+
+	// The number of independent contact islands solved last step
+	size_t GetNumIslands() const;
+
+	// Counts, energy and phase timings totalled over the steps the last Update
+	// ran (see PhysicsWorld::Stats::Add). Step adds to these, Update starts over
+	PhysicsWorld::Stats GetStats() const;
+
+	// Serial solves islands concurrently, Colored solves all contacts in parallel batches
+	void SetSolverMode( Contact::Solver::EMode eMode );
+	Contact::Solver::EMode GetSolverMode() const;
+
+	// Bodies that come to rest are put to sleep, and woken when an awake body touches them
+	void SetAllowSleep( bool bAllowSleep );
+	bool GetAllowSleep() const;
+
+	// Wake a sleeping body, returns false if there's no such body
+	bool WakeRigidBody( const size_t rbIdx );
+
+	// Collision layers of a body (see PhysicsWorld::SetCollisionFilter),
+	// the gets return 0 if there's no such body
+	bool SetCollisionFilter( const size_t rbIdx, const uint32_t uCategory, const uint32_t uMask );
+	uint32_t GetCollisionCategory( const size_t rbIdx ) const;
+	uint32_t GetCollisionMask( const size_t rbIdx ) const;
+	void WakeAll();
+
+	// The number of dynamic bodies that are awake / asleep
+	size_t GetNumAwakeBodies() const;
+	size_t GetNumSleepingBodies() const;
+
+	// The length of a fixed step, which belongs to this scene's world.
+	// Returns false if fDT isn't a positive number
+	bool SetTimeStep( float fDT );
+	float GetTimeStep() const;
+
+	// The most steps one Update will run, time past that is dropped
+	void SetMaxSubsteps( uint32_t uMaxSubsteps );
+	uint32_t GetMaxSubsteps() const;
+
+	// The number of steps the last Update ran
+	uint32_t GetNumSubsteps() const;
+
+	// How far into the next step the time left over from the last Update
+	// is (from 0 to 1), and a body's transform blended by that much between
+	// the last two steps. Drawing with these hides the step rate
+	float GetInterpolationAlpha() const;
+	quatvec GetInterpolatedQuatVec( const size_t rbIdx ) const;
+
+	// Scale applied to last step's impulses when warm starting contacts (0 disables it)
+	void SetWarmStartFactor( float fFactor );
+	float GetWarmStartFactor() const;
+
+	// Write the bodies, contact cache, time step and voices to a binary file, or
+	// put them back from one (see Snapshot.h). Drawables aren't saved, so scripts
+	// have to keep theirs lined up with the bodies. Both sections are checked
+	// before either is loaded, so a failed load leaves the scene as it was
+	bool SaveSnapshot( std::string strFileName ) const;
+	bool LoadSnapshot( std::string strFileName );
+
 private:
+	struct DrawableBinding
+	{
+		uint32_t uRigidBodyIdx;
+		uint32_t uDrawableIdx;
+	};
+
 	bool m_bQuitFlag;
 	bool m_bDrawContacts;
 	bool m_bPauseCollision;
@@ -52,8 +185,17 @@ private:
 	Shader m_Shader;
 	SoundManager m_SoundManager;
 	Camera m_Camera;
-	std::list<Contact> m_liSpeculativeContacts;
-	Contact::Solver m_ContactSolver;
+	bool m_bClockStarted;
+	decltype(Time::now()) m_tLastUpdate;
+	float m_fAccumulator;				// Wall time that hasn't been simulated yet
+	uint32_t m_uMaxSubsteps;
+	uint32_t m_uNumSubsteps;
+	PhysicsWorld m_PhysicsWorld;
+	std::vector<PhysicsWorld::CollisionEvent> m_vCollisionEvents;	// From every step since the last Update
+	PhysicsWorld::Stats m_FrameStats;	// Same
+	std::vector<uint32_t> m_vCollisionCounts;	// Indexed by ID, since the last reset
+	BatchRunner m_BatchRunner;			// Physics only worlds for offline runs
 	std::vector<Drawable> m_vDrawables;
-	std::vector<RigidBody2D> m_vRigidBodies;
+	std::vector<DrawableBinding> m_vDrawableBindings;	// Synced after every Update
+	SpatialQueryCache m_SpatialQueryCache;	// What the queries run against
 };
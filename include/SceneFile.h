@@ -0,0 +1,21 @@
+#pragma once
+
+#include "PhysicsWorld.h"
+
+#include <string>
+
+// Scene descriptions are text files with one body per line:
+//
+//	circle	x y vx vy mass elasticity radius
+//	aabb	x y vx vy mass elasticity width height
+//	obb		x y vx vy mass elasticity width height theta
+//
+// Static bodies have a negative mass, as in Scene::AddRigidBody. A line
+//
+//	grid nx ny dx dy
+//
+// repeats the body on the next line nx * ny times, offset by (i * dx, j * dy),
+// and "timestep dt" sets the step length. Anything after a # is ignored.
+// Returns the number of bodies added, or -1 if the file couldn't be read or
+// a line is malformed (bodies before that line stay in the world)
+int LoadSceneFile( const std::string& strFileName, PhysicsWorld& world );
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+// Binary snapshots are a run of sections (the physics world, then the sound
+// manager), each a small header followed by arrays of plain structs that are
+// copied in and out as raw bytes. That makes saving and loading a straight
+// copy, but a snapshot only loads on a build with the same struct layouts,
+// so every header carries a magic number, a version and the sizes it expects
+
+// Appends raw copies of plain structs to a byte buffer
+class SnapshotWriter
+{
+public:
+	SnapshotWriter( std::vector<uint8_t>& vData );
+
+	template<typename T>
+	void Write( const T * pData, const size_t nCount )
+	{
+		const size_t uBytes = nCount * sizeof( T );
+		const size_t uOffset = m_vData.size();
+		m_vData.resize( uOffset + uBytes );
+		if ( uBytes )
+			memcpy( &m_vData[uOffset], pData, uBytes );
+	}
+
+	template<typename T>
+	void Write( const T& data )
+	{
+		Write( &data, 1 );
+	}
+
+private:
+	std::vector<uint8_t>& m_vData;
+};
+
+// Reads raw copies back out of a byte buffer, failing rather than running off the end
+class SnapshotReader
+{
+public:
+	SnapshotReader( const uint8_t * pData, const size_t uSize );
+
+	template<typename T>
+	bool Read( T * pData, const size_t nCount )
+	{
+		const size_t uBytes = nCount * sizeof( T );
+		if ( nCount > GetRemaining() / sizeof( T ) )
+			return false;
+		if ( uBytes )
+			memcpy( pData, m_pCur, uBytes );
+		m_pCur += uBytes;
+		return true;
+	}
+
+	template<typename T>
+	bool Read( T& data )
+	{
+		return Read( &data, 1 );
+	}
+
+	size_t GetRemaining() const;
+
+private:
+	const uint8_t * m_pCur;
+	const uint8_t * m_pEnd;
+};
+
+// Whole file helpers, these return false if the file couldn't be written or read
+bool WriteSnapshotFile( const std::string& strFileName, const std::vector<uint8_t>& vData );
+bool ReadSnapshotFile( const std::string& strFileName, std::vector<uint8_t>& vData );
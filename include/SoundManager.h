@@ -7,6 +7,8 @@
 #include <stdint.h>
 #include <memory>
 
+#include "Snapshot.h"
+
 // Forwards for clip and voice
 class Clip;
 class Voice;
@@ -76,6 +78,25 @@ public:
 	// Add a clip to storage, can be recalled later as a Voice
 	bool RegisterClip( std::string strClipName, std::string strHeadFile, std::string strTailFile, size_t uFadeDurationMS );
 
+	// Copy the playback position and voices out to / back in from a snapshot
+	// (see Snapshot.h). The audio thread is locked out while this happens.
+	// Voices refer to clips by their place among the registered clips,
+	// so a snapshot only loads if the same clips have been registered. Like
+	// PhysicsWorld, loading is ReadSnapshot then ApplySnapshot
+	struct SnapshotState
+	{
+		std::list<Voice> liVoices;
+		uint64_t uSamplePos;
+
+		// Out of line, Voice isn't complete here
+		SnapshotState();
+		~SnapshotState();
+	};
+	void SaveSnapshot( SnapshotWriter& writer ) const;
+	bool LoadSnapshot( SnapshotReader& reader );
+	bool ReadSnapshot( SnapshotReader& reader, SnapshotState& state ) const;
+	void ApplySnapshot( SnapshotState& state );
+
 	// SDL Audio callback, will end up calling fill_audio_impl on a SoundManager instance
 	static void FillAudio( void * pUserData, uint8_t * pStream, int nSamplesDesired );
 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "RigidBody2D.h"
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+#include <stdint.h>
+
+// Batched point, box and ray queries against every body in a world.
+// A SpatialQuery is a copy of the bodies taken at one moment (see
+// PhysicsWorld::MakeSpatialQuery) and never changes afterwards, so any
+// number of threads can query it while the world keeps stepping.
+// Like the broadphase, bodies are kept sorted along x; a query only
+// looks at the bodies whose x interval could reach it, then tests
+// those against the actual shapes
+class SpatialQuery
+{
+public:
+	// One body a query touched, packed so a whole
+	// list can be handed to scripts as raw memory
+	struct Hit
+	{
+		uint32_t uQueryIdx;	// Which query in the batch
+		uint32_t uBodyIdx;	// Rigid body index in the world
+		int32_t iID;		// The body's EntComponent ID
+		float fT;			// Distance along a ray to the hit, 0 for points and boxes
+	};
+
+	// vOrder is a guess at the bodies' order along x (the broadphase's),
+	// bodies it doesn't mention are added and the order is fixed up
+	SpatialQuery( const std::vector<RigidBody2D>& vRigidBodies, const std::vector<uint32_t>& vOrder );
+
+	// Each of these appends to vHits, sorted by query index, and only reports bodies
+	// whose category is in uMask. Box queries are given by their corners, rays by an
+	// origin, a direction (it needn't be unit length) and the longest distance to look.
+	// Hits for a point or box are sorted by body, ray hits nearest first (a ray starting
+	// inside a body hits it at 0). If the lists for one kind of query aren't the same
+	// length the extra entries are ignored. The number of hits added is returned
+	size_t QueryPoints( const std::vector<glm::vec2>& vPoints, std::vector<Hit>& vHits, const uint32_t uMask = ~0u ) const;
+	size_t QueryBoxes( const std::vector<glm::vec2>& vMin, const std::vector<glm::vec2>& vMax, std::vector<Hit>& vHits, const uint32_t uMask = ~0u ) const;
+	size_t QueryRays( const std::vector<glm::vec2>& vOrigins, const std::vector<glm::vec2>& vDirs, const std::vector<float>& vLengths, std::vector<Hit>& vHits, const uint32_t uMask = ~0u ) const;
+
+	size_t GetNumRigidBodies() const;
+
+private:
+	std::vector<RigidBody2D> m_vRigidBodies;	// Copies, in world order
+	std::vector<uint32_t> m_vSorted;			// Body indices sorted by lower x bound
+	std::vector<float> m_vSortedMinX;			// Their lower x bounds, for the binary search
+	std::vector<uint32_t> m_vWide;				// Bodies too wide to be found through m_vSorted
+	std::vector<glm::vec2> m_vMin;				// Bounds of every body, in world order
+	std::vector<glm::vec2> m_vMax;
+	float m_fMaxWidth;							// Widest body in m_vSorted
+
+	// Call fnVisit with every body whose bounds overlap [v2Min, v2Max]
+	// and whose category is in uMask, in no particular order
+	template <typename F>
+	void forEachCandidate( const glm::vec2 v2Min, const glm::vec2 v2Max, const uint32_t uMask, F fnVisit ) const;
+};
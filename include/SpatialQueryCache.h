@@ -0,0 +1,38 @@
+#pragma once
+
+#include "SpatialQuery.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+class PhysicsWorld;
+
+// Keeps the SpatialQuery a world's queries run against, and hands it to any
+// thread. The thread that steps the world calls Update once it's done stepping;
+// a new copy is only taken if the bodies changed and the last copy was asked
+// for (or there isn't one yet). Otherwise the old copy is kept, so a query
+// always has something to run against, and the next Update after someone asks
+// for it brings it up to date. Only the pointer swap is locked
+class SpatialQueryCache
+{
+public:
+	SpatialQueryCache();
+
+	// The bodies were added, moved or changed since the last copy
+	void Invalidate();
+	bool IsStale() const;
+
+	// Take a new copy of world's bodies if it's needed (see above), or right away
+	void Update( const PhysicsWorld& world );
+	void Refresh( const PhysicsWorld& world );
+
+	// The latest copy, which stays valid for as long as it's held. Safe to call from any thread
+	std::shared_ptr<const SpatialQuery> Get() const;
+
+private:
+	bool m_bStale;							// Bodies changed since the last copy
+	mutable std::atomic<bool> m_bUsed;		// Asked for since the last copy
+	mutable std::mutex m_muQuery;			// Guards the pointer, not what it points to
+	std::shared_ptr<const SpatialQuery> m_pQuery;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "RigidBody2D.h"
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+#include <stdint.h>
+
+// Sweep and prune broadphase. Every body gets an interval along the x axis
+// whose endpoints are kept sorted across frames; because bodies don't move
+// much in one step an insertion sort is close to linear. Sweeping the sorted
+// endpoints gives the pairs that overlap in x, which are then tested in y
+class SweepAndPrune
+{
+public:
+	// A pair of rigid body indices whose bounds overlap (uIdxA < uIdxB)
+	struct Pair
+	{
+		uint32_t uIdxA;
+		uint32_t uIdxB;
+	};
+
+	SweepAndPrune();
+
+	// Update bounds, re-sort endpoints and find the candidate pairs for this step
+	const std::vector<Pair>& FindPairs( const std::vector<RigidBody2D>& vRigidBodies, const float fDT );
+
+	// Forget the endpoint order, for when every body has been replaced
+	void Clear();
+
+	// The candidate pairs found by the last call to FindPairs
+	const std::vector<Pair>& GetPairs() const;
+	size_t GetNumCandidatePairs() const;
+
+	// Body indices in order of their padded lower x bounds, as of the last call to FindPairs
+	void GetOrderByMinX( std::vector<uint32_t>& vOrder ) const;
+
+	// Extra padding added to every body's bounds, on top of its speculative motion
+	void SetMargin( const float fMargin );
+	float GetMargin() const;
+
+private:
+	// An interval endpoint; uData is the body index shifted left once,
+	// with the low bit set if this is the max end of the interval
+	struct Endpoint
+	{
+		float fValue;
+		uint32_t uData;
+	};
+
+	float m_fMargin;					// Padding added to all bounds
+	std::vector<Endpoint> m_vEndpoints;	// Sorted x endpoints, persist across frames
+	std::vector<glm::vec2> m_vMin;		// Padded lower bounds of each body
+	std::vector<glm::vec2> m_vMax;		// Padded upper bounds of each body
+	std::vector<uint32_t> m_vActive;	// Bodies whose x interval is open during the sweep
+	std::vector<Pair> m_vPairs;			// The output pairs
+
+	void updateBounds( const std::vector<RigidBody2D>& vRigidBodies, const float fDT );
+	void sortEndpoints();
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <stdint.h>
+
+// A small pool of worker threads used to run parallel loops.
+// The calling thread joins in, so a pool created with one
+// thread has no workers and just runs everything inline
+class ThreadPool
+{
+public:
+	// If nThreads is 0 the hardware concurrency is used
+	ThreadPool( size_t nThreads = 0 );
+	~ThreadPool();
+
+	ThreadPool( const ThreadPool& ) = delete;
+	ThreadPool& operator=( const ThreadPool& ) = delete;
+
+	// The number of threads that run tasks, including the caller
+	size_t GetNumThreads() const;
+
+	// Call fnTask( i ) for every i in [0, nTasks), spread across the pool.
+	// Tasks are handed out in order, so put the expensive ones first.
+	// Blocks until every task is done; must not be called from inside a task
+	void ParallelFor( size_t nTasks, const std::function<void( size_t )>& fnTask );
+
+private:
+	std::vector<std::thread> m_vWorkers;
+	std::mutex m_muJob;								// Guards everything below but m_uNextTask
+	std::condition_variable m_cvStart;				// Signals workers that a job is ready
+	std::condition_variable m_cvDone;				// Signals the caller that workers are done
+	const std::function<void( size_t )> * m_pTask;	// The current job
+	size_t m_nTasks;								// Its task count
+	std::atomic<size_t> m_uNextTask;				// The next task to be handed out
+	size_t m_nBusyWorkers;							// Workers that haven't finished the job
+	uint64_t m_uJobID;								// Incremented for every job
+	bool m_bQuit;
+
+	void workerLoop();
+	void runTasks( const std::function<void( size_t )>& fnTask, const size_t nTasks );
+};
@@ -7,8 +7,19 @@
 
 // Smol
 const float kEPS = 0.001f;
-const float g_fTimeStep = 0.005f;
-const float g_fInvTimeStep = 1.f / 0.005f;
+
+// Length of one simulation step until a world is given another
+// (each PhysicsWorld keeps its own, see PhysicsWorld::SetTimeStep)
+const float kDefaultTimeStep = 0.005f;
+
+// Slack given to speculative tests, since velocities
+// can change while the contact solver iterates
+const float g_fSpeculativeMargin = 0.1f;
+
+// Bodies that stay slower than these for g_fTimeToSleep seconds are put to sleep
+const float g_fSleepLinearVel = 0.05f;
+const float g_fSleepAngularVel = 0.05f;
+const float g_fTimeToSleep = 0.5f;
 
 // remaps x : [m0, M0] to the range of [m1, M1]
 inline float remap( float x, float m0, float M0, float m1, float M1 )
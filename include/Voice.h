@@ -33,6 +33,26 @@ public:
 	// Construct with soundmanager command
 	Voice( const SoundManager::Command cmd );
 
+	// Everything about a voice but its clip, as plain data for snapshots
+	// (the SoundManager saves the clip as its place among the registered clips)
+	struct Record
+	{
+		int32_t iUniqueID;
+		int32_t iState;		// EState, as plain ints so a damaged
+		int32_t iPrevState;	// snapshot can't load an enum out of range
+		float fVolume;
+		uint64_t uTriggerRes;
+		uint64_t uStartingPos;
+		uint64_t uLastTailSampleAdded;
+		uint32_t uClipIdx;
+		uint32_t uPad;		// Always 0, so every byte of a saved record is set
+	};
+
+	// Construct from a record with the clip it refers to,
+	// the record's states have to be checked with IsValidRecord
+	Voice( const Record& rec, const Clip * pClip );
+	static bool IsValidRecord( const Record& rec );
+
 	// Possibly copy uSamplesDesired of float sampels into pMixBuffer
 	void RenderData( float * const pMixBuffer, const size_t uSamplesDesired, const size_t uSamplePos );
 
@@ -41,6 +61,8 @@ public:
 	EState GetPrevState() const;
 	float GetVolume() const;
 	int GetID() const;
+	const Clip * GetClip() const;
+	Record GetRecord( const uint32_t uClipIdx ) const;
 
 	// Set the voice to start/stop at the trigger res
 	void SetStopping( const size_t uTriggerRes );
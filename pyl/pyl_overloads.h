@@ -6,6 +6,7 @@
 #include "../include/RigidBody2D.h"
 #include "../include/Contact.h"
 #include "../include/quatvec.h"
+#include "../include/PhysicsWorld.h"
 
 namespace pyl
 {
@@ -16,8 +17,13 @@ namespace pyl
 	bool convert( PyObject *, quatvec& );
 	bool convert( PyObject *, RigidBody2D::EType& );
 	bool convert( PyObject *, SoundManager::ECommandID& );
+	bool convert( PyObject *, Contact::Solver::EMode& );
 
 	PyObject * alloc_pyobject( const SoundManager::ECommandID );
 	PyObject * alloc_pyobject( const RigidBody2D::EType );
+	PyObject * alloc_pyobject( const Contact::Solver::EMode );
 	PyObject * alloc_pyobject( const quatvec& );
+	PyObject * alloc_pyobject( const PhysicsWorld::Stats& );
+	PyObject * alloc_pyobject( const std::vector<PhysicsWorld::CollisionEvent>& );
+	PyObject * alloc_pyobject( const std::vector<SpatialQuery::Hit>& );
 }
\ No newline at end of file
@@ -1,6 +1,3 @@
-from pylContact import Contact
-from pylRigidBody2D import RigidBody2D
-
 class Engine:
     # Construct with a list of entities, the sound manager,
     # and the wrapped C++ scene
@@ -10,31 +7,15 @@ class Engine:
         self.m_cScene = cScene
 
     def Update(self): 
-        # Call the C++ scene's update function
+        # Call the C++ scene's update function, which also
+        # moves every entity's drawable to its rigid body
         self.m_cScene.Update()
 
-        # Get all colliding objects
-        liContacts = [Contact(c) for c in self.m_cScene.GetContacts()]
-        liCollidingContacts = [(RigidBody2D(c.GetBodyA()), RigidBody2D(c.GetBodyB())) for c in liContacts if c.IsColliding()]
-        
-        # Iterate over the colliding contacts 
-        for c in liCollidingContacts:
-            id1 = c[0].GetID()
-            id2 = c[1].GetID()
-            # walls have negative IDs
-            if id1 >= 0 and id2 >= 0:
-                # Let entities know what happened
-                self.m_liEntities[id1].HandleCollision(c)
-                self.m_liEntities[id2].HandleCollision(c)
-               
-        # Update every entity in the engine
-        for e in self.m_liEntities:
-            e.Update()
-
-        # Find the entity with the most collisions, set the
-        # loop graph's active stim to be the input stim of the node
-        # (so it is queued to play when the loop graph updates)
-        eMax = max(self.m_liEntities, key = lambda e : e.colCount)
+        # Find the entity with the most collisions (the scene counts them
+        # by entity ID), set the loop graph's active stim to be the input
+        # stim of the node (so it is queued to play when the loop graph updates)
+        idMax = self.m_cScene.GetMostCollidedID()
+        eMax = self.m_liEntities[max(idMax, 0)]
         self.m_SoundManager.GetStateGraph().stim = eMax.soundNode.inputStim
 
         # Update the sound manager
@@ -45,8 +26,7 @@ class Engine:
 
     # Clear each entity's collision counter
     def ClearColCount(self):
-        for e in self.m_liEntities:
-            e.colCount = 0
+        self.m_cScene.ResetCollisionCounts()
 
     # Toggle the play state of the sound manager
     def StartStop(self, bStart):
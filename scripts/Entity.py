@@ -11,8 +11,6 @@ class Entity:
         self.colIdx = colIdx
         self.drIdx = drIdx
         self.soundNode = cSound
-        self.liCollisions = []
-        self.colCount = 0
 
         # Store our unique ent ID (a class variable)
         # and set the C++ component ID accodingly
@@ -24,6 +22,10 @@ class Entity:
         # (this could use a redesign)
         self.soundNode.SetDrawableIdx(self.drIdx)
 
+        # The scene moves our drawable along with our
+        # rigid body every update, so we don't have to
+        self.cScene.BindDrawable(self.colIdx, self.drIdx)
+
         # Ensure each ent has its own ID
         Entity.nEntsCreated += 1
 
@@ -33,14 +35,6 @@ class Entity:
     def GetCollisionComponent(self):
         return RigidBody2D(self.cScene.GetRigidBody2D(self.colIdx))
 
-    def Update(self):
-        # Update drawable transform
-        self.GetDrawableComponent().SetTransform(self.GetCollisionComponent().GetQuatVec())
-        # Add collisions and clear collision list
-        self.colCount += len(self.liCollisions)
-        self.liCollisions.clear()
-
-    # Just make a note that this happened,
-    # this list is periodically cleared (above)
-    def HandleCollision(self, eOther):
-        self.liCollisions.append(eOther)     
\ No newline at end of file
+    # The number of collisions since the engine last cleared them
+    def GetColCount(self):
+        return self.cScene.GetCollisionCount(self.ID)     
\ No newline at end of file
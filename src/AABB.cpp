@@ -1,6 +1,6 @@
 #include "RigidBody2D.h"
 #include "CollisionFunctions.h"
-#include "GL_Util.h"
+#include "Glm_Util.h"
 #include "Util.h"
 #include <glm/gtx/norm.hpp>
 
@@ -18,22 +18,22 @@ float AABB::Height() const
 
 float AABB::Left() const
 {
-	return v2Center.x - boxData.v2HalfDim.x;
+	return GetCenter().x - boxData.v2HalfDim.x;
 }
 
 float AABB::Right() const
 {
-	return v2Center.x + boxData.v2HalfDim.x;
+	return GetCenter().x + boxData.v2HalfDim.x;
 }
 
 float AABB::Top() const
 {
-	return v2Center.y + boxData.v2HalfDim.y;
+	return GetCenter().y + boxData.v2HalfDim.y;
 }
 
 float AABB::Bottom() const
 {
-	return v2Center.y - boxData.v2HalfDim.y;
+	return GetCenter().y - boxData.v2HalfDim.y;
 }
 
 glm::vec2 AABB::HalfDim() const
@@ -43,7 +43,7 @@ glm::vec2 AABB::HalfDim() const
 
 glm::vec2 AABB::Clamp( const glm::vec2 p ) const
 {
-	return glm::clamp( p, v2Center - boxData.v2HalfDim, v2Center + boxData.v2HalfDim );
+	return glm::clamp( p, GetCenter() - boxData.v2HalfDim, GetCenter() + boxData.v2HalfDim );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -77,6 +77,8 @@ glm::vec2 AABB::GetFaceNormalFromPoint( const glm::vec2 p ) const
 	RigidBody2D ret = RigidBody2D::Create( vel, c, mass, elasticity );
 	ret.boxData.v2HalfDim = v2R;
 	ret.eType = RigidBody2D::EType::AABB;
+	ret.UpdateInverseMass();
+	ret.UpdateBoxGeometry();
 	return ret;
 }
 
@@ -87,14 +89,20 @@ glm::vec2 AABB::GetFaceNormalFromPoint( const glm::vec2 p ) const
 	RigidBody2D ret = RigidBody2D::Create( vel, vec2( x, y ), mass, elasticity );
 	ret.boxData.v2HalfDim = vec2( w, h ) / 2.f;
 	ret.eType = RigidBody2D::EType::AABB;
+	ret.UpdateInverseMass();
+	ret.UpdateBoxGeometry();
 	return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 // This is rather verbose, but it gets the job done
-std::list<Contact> GetSpecContacts( AABB * pA, AABB * pB )
+uint32_t GetSpecContacts( AABB * pA, AABB * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
 {
+	// Don't bother if these two can't reach each other this step
+	if ( IsOutsideSpeculativeMargin( pA, pB, fDT ) )
+		return 0;
+
 	// Contact normal and indices from each box
 	vec2 n;
 	int vIdxA, vIdxB;
@@ -245,7 +253,10 @@ std::list<Contact> GetSpecContacts( AABB * pA, AABB * pB )
 		vec2 posB = GetVert( pB, vIdxB );
 		n = glm::normalize( posB - posA );
 		float fDist = glm::distance( posA, posB );
-		return{ Contact( pA, pB, posA, posB, n, fDist ) };
+
+		// Corner features come after the 16 face pairs
+		vContacts.emplace_back( pA, pB, posA, posB, n, fDist, 16 + 4 * vIdxA + vIdxB );
+		return 1;
 	}
 
 	// For the face case, we get the two vertices from each colliding face
@@ -254,26 +265,27 @@ std::list<Contact> GetSpecContacts( AABB * pA, AABB * pB )
 	vec2 posA = 0.5f * (GetVert( pA, vIdxA ) + GetVert( pA, vIdxA + 1 ));
 	vec2 posB = 0.5f * (GetVert( pB, vIdxB ) + GetVert( pB, vIdxB + 1 ));
 	float fDist = glm::dot( n, posB - posA );
-	return{ Contact( pA, pB, posA, posB, n, fDist ) };
+	vContacts.emplace_back( pA, pB, posA, posB, n, fDist, 4 * vIdxA + vIdxB );
+	return 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
-std::list<Contact> GetSpecContacts( AABB * pAABB, OBB * pOBB )
+uint32_t GetSpecContacts( AABB * pAABB, OBB * pOBB, std::vector<Contact>& vContacts, const float fDT ) noexcept
 {
 	// I do think there is some optimization to be had here,
 	// but for now what works is to treat the AABB as if it was an
 	// OBB. This is bad for reasons of efficiency due to the expense
 	//  of the test and correctness to the the AABB's inability to rotate
-	return GetSpecContacts( (OBB *) pAABB, pOBB );
+	return GetSpecContacts( (OBB *) pAABB, pOBB, vContacts, fDT );
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 bool IsPointInside( vec2 p, AABB * pAABB )
 {
-	bool bX = fabs( p.x - pAABB->v2Center.x ) < pAABB->boxData.v2HalfDim.x;
-	bool bY = fabs( p.y - pAABB->v2Center.y ) < pAABB->boxData.v2HalfDim.y;
+	bool bX = fabs( p.x - pAABB->GetCenter().x ) < pAABB->boxData.v2HalfDim.x;
+	bool bY = fabs( p.y - pAABB->GetCenter().y ) < pAABB->boxData.v2HalfDim.y;
 	return bX && bY;
 }
 
@@ -320,20 +332,8 @@ bool IsOverlapping( AABB * pAABB, OBB * pOBB )
 
 glm::vec2 GetVert( AABB * pAABB, int idx )
 {
-	vec2 ret( 0 );
-	vec2 R = pAABB->boxData.v2HalfDim;	// 3---0
-	switch ( (idx + 4) % 4 )			// |   |
-	{									// 2---1
-		case 0:
-			return pAABB->v2Center + R;
-		case 1:
-			return pAABB->v2Center + vec2( R.x, -R.y );
-		case 2:
-			return pAABB->v2Center - R;
-		case 3:
-		default:
-			return pAABB->v2Center + vec2( -R.x, R.y );
-	}
+	// Corners are cached by UpdateBoxGeometry
+	return pAABB->boxData.av2Verts[(idx + 4) % 4];
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,126 @@
+#include "BatchRunner.h"
+#include "SceneFile.h"
+
+#include <algorithm>
+
+BatchRunner::BatchRunner( size_t nThreads /*= 0*/ ) :
+	m_nThreads( nThreads )
+{}
+
+size_t BatchRunner::AddWorld()
+{
+	// The world gets no threads of its own, the batch pool is plenty
+	m_vWorlds.emplace_back( new PhysicsWorld( 1 ) );
+	return m_vWorlds.size() - 1;
+}
+
+int BatchRunner::AddRigidBody( size_t worldIdx, RigidBody2D::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails )
+{
+	if ( PhysicsWorld * pWorld = GetWorld( worldIdx ) )
+		return pWorld->AddRigidBody( eType, v2Vel, v2Pos, fMass, fElasticity, mapDetails );
+	return -1;
+}
+
+int BatchRunner::LoadSceneFile( size_t worldIdx, std::string strFileName )
+{
+	if ( PhysicsWorld * pWorld = GetWorld( worldIdx ) )
+		return ::LoadSceneFile( strFileName, *pWorld );
+	return -1;
+}
+
+PhysicsWorld * BatchRunner::GetWorld( const size_t worldIdx )
+{
+	if ( worldIdx < m_vWorlds.size() )
+		return m_vWorlds[worldIdx].get();
+	return nullptr;
+}
+
+size_t BatchRunner::GetNumWorlds() const
+{
+	return m_vWorlds.size();
+}
+
+void BatchRunner::Clear()
+{
+	m_vWorlds.clear();
+	m_vBodyOffsets.clear();
+	m_vPositions.clear();
+	m_vCollisionCounts.clear();
+}
+
+void BatchRunner::SetNumThreads( size_t nThreads )
+{
+	// The pool gets remade on the next Run
+	if ( nThreads != m_nThreads )
+	{
+		m_nThreads = nThreads;
+		m_pThreadPool.reset();
+	}
+}
+
+size_t BatchRunner::GetNumThreads() const
+{
+	return m_pThreadPool ? m_pThreadPool->GetNumThreads() : m_nThreads;
+}
+
+void BatchRunner::Run( uint32_t nSteps )
+{
+	if ( m_pThreadPool == nullptr )
+		m_pThreadPool.reset( new ThreadPool( m_nThreads ) );
+
+	// Lay out the results so every world writes its own slice
+	m_vBodyOffsets.resize( m_vWorlds.size() + 1 );
+	m_vBodyOffsets[0] = 0;
+	for ( size_t i = 0; i < m_vWorlds.size(); i++ )
+		m_vBodyOffsets[i + 1] = m_vBodyOffsets[i] + (uint32_t) m_vWorlds[i]->GetNumRigidBodies();
+
+	m_vPositions.assign( 3 * m_vBodyOffsets.back(), 0.f );
+	m_vCollisionCounts.assign( m_vBodyOffsets.back(), 0 );
+
+	m_pThreadPool->ParallelFor( m_vWorlds.size(), [this, nSteps] ( size_t i )
+	{
+		PhysicsWorld& world = *m_vWorlds[i];
+		const uint32_t uOffset = m_vBodyOffsets[i];
+		uint32_t * pCounts = m_vCollisionCounts.data() + uOffset;
+
+		for ( uint32_t s = 0; s < nSteps; s++ )
+		{
+			world.Step();
+
+			// Contacts point into the world's body array
+			const RigidBody2D * pBodies = world.GetRigidBody2D( 0 );
+			for ( const Contact& c : world.GetContactBuffer() )
+			{
+				if ( c.IsColliding() )
+				{
+					pCounts[c.GetBodyA() - pBodies]++;
+					pCounts[c.GetBodyB() - pBodies]++;
+				}
+			}
+		}
+
+		float * pPositions = m_vPositions.data() + 3 * uOffset;
+		for ( size_t b = 0; b < world.GetNumRigidBodies(); b++ )
+		{
+			const RigidBody2D * pRB = world.GetRigidBody2D( b );
+			pPositions[3 * b + 0] = pRB->GetCenter().x;
+			pPositions[3 * b + 1] = pRB->GetCenter().y;
+			pPositions[3 * b + 2] = pRB->GetTheta();
+		}
+	} );
+}
+
+const std::vector<uint32_t>& BatchRunner::GetBodyOffsets() const
+{
+	return m_vBodyOffsets;
+}
+
+const std::vector<float>& BatchRunner::GetPositions() const
+{
+	return m_vPositions;
+}
+
+const std::vector<uint32_t>& BatchRunner::GetCollisionCounts() const
+{
+	return m_vCollisionCounts;
+}
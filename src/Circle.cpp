@@ -1,7 +1,7 @@
 
 #include "RigidBody2D.h"
 #include "CollisionFunctions.h"
-#include "GL_Util.h"
+#include "Glm_Util.h"
 #include "Util.h"
 
 #include <glm/gtx/norm.hpp>
@@ -13,6 +13,7 @@
 	RigidBody2D ret = RigidBody2D::Create( vel, c, mass, elasticity );
 	ret.circData.fRadius = radius;
 	ret.eType = RigidBody2D::EType::Circle;
+	ret.UpdateInverseMass();
 	return ret;
 }
 
@@ -25,15 +26,20 @@ float Circle::Radius() const
 
 ////////////////////////////////////////////////////////////////////////////
 
-std::list<Contact> GetSpecContacts( Circle * pA, Circle * pB )
+uint32_t GetSpecContacts( Circle * pA, Circle * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
 {
-	// find and normalize distance
-	vec2 d = pB->v2Center - pA->v2Center;
-	vec2 n = glm::normalize( d );
+	// Don't bother if these two can't reach each other this step
+	if ( IsOutsideSpeculativeMargin( pA, pB, fDT ) )
+		return 0;
+
+	// find and normalize distance (circles on top of each other get +x)
+	vec2 d = pB->GetCenter() - pA->GetCenter();
+	float fLen = glm::length( d );
+	vec2 n = fLen < kEPS ? vec2( 1, 0 ) : glm::normalize( d );
 
 	// contact points along circumference
-	vec2 a_pos = pA->v2Center + n * pA->Radius();
-	vec2 b_pos = pB->v2Center - n * pB->Radius();
+	vec2 a_pos = pA->GetCenter() + n * pA->Radius();
+	vec2 b_pos = pB->GetCenter() - n * pB->Radius();
 
 	// distance between circumferences
 	float dist = glm::length( a_pos - b_pos );
@@ -45,23 +51,28 @@ std::list<Contact> GetSpecContacts( Circle * pA, Circle * pB )
 	}
 
 	// Construct and return
-	return{ Contact( pA, pB, a_pos, b_pos, n, dist ) };
+	vContacts.emplace_back( pA, pB, a_pos, b_pos, n, dist );
+	return 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 // Simlar to the AABB case, but we only care about the center of the circle
-std::list<Contact> GetSpecContacts( Circle * pCirc, AABB *  pAABB)
+uint32_t GetSpecContacts( Circle * pCirc, AABB *  pAABB, std::vector<Contact>& vContacts, const float fDT ) noexcept
 {
+	// Don't bother if these two can't reach each other this step
+	if ( IsOutsideSpeculativeMargin( pCirc, pAABB, fDT ) )
+		return 0;
+
 	// Determine which feature region we're on
 	vec2 n;
 	int vIdx( -1 );
 
 	// top/bottom face region
-	if ( (pAABB->Right() < pCirc->v2Center.x || pAABB->Left() > pCirc->v2Center.x) == false )
+	if ( (pAABB->Right() < pCirc->GetCenter().x || pAABB->Left() > pCirc->GetCenter().x) == false )
 	{
 		// Circle is below box
-		if ( pCirc->v2Center.y < pAABB->Bottom() )
+		if ( pCirc->GetCenter().y < pAABB->Bottom() )
 		{
 			vIdx = 1;
 			n = vec2( 0, 1 );
@@ -73,10 +84,10 @@ std::list<Contact> GetSpecContacts( Circle * pCirc, AABB *  pAABB)
 		}
 	}
 	// left/right face region
-	else if ( (pAABB->Top() < pCirc->v2Center.y || pAABB->Bottom() > pCirc->v2Center.y) == false )
+	else if ( (pAABB->Top() < pCirc->GetCenter().y || pAABB->Bottom() > pCirc->GetCenter().y) == false )
 	{
 		// Circle is to the left of the box
-		if ( pCirc->v2Center.x < pAABB->Left() )
+		if ( pCirc->GetCenter().x < pAABB->Left() )
 		{
 			vIdx = 2;
 			n = vec2( 1, 0 );
@@ -91,8 +102,8 @@ std::list<Contact> GetSpecContacts( Circle * pCirc, AABB *  pAABB)
 	else
 	{
 		// Determine which vertex
-		bool bAIsLeft = (pCirc->v2Center.x < pAABB->Left());
-		bool bAIsBelow = (pCirc->v2Center.y < pAABB->Bottom());
+		bool bAIsLeft = (pCirc->GetCenter().x < pAABB->Left());
+		bool bAIsBelow = (pCirc->GetCenter().y < pAABB->Bottom());
 		if ( bAIsLeft )
 		{
 			if ( bAIsBelow )
@@ -110,39 +121,56 @@ std::list<Contact> GetSpecContacts( Circle * pCirc, AABB *  pAABB)
 
 		// We don't need to average contact positions for the corner case
 		vec2 posB = GetVert( pAABB, vIdx );
-		n = glm::normalize( posB - pCirc->v2Center );
-		vec2 posA = pCirc->v2Center + pCirc->circData.fRadius * n;
+		n = glm::normalize( posB - pCirc->GetCenter() );
+		vec2 posA = pCirc->GetCenter() + pCirc->circData.fRadius * n;
 		float fDist = glm::distance( posA, posB );
-		return{ Contact( pCirc, pAABB, posA, posB, n, fDist ) };
+
+		// Vertex regions are features 4-7
+		vContacts.emplace_back( pCirc, pAABB, posA, posB, n, fDist, 4 + vIdx );
+		return 1;
 	}
 	// For a face region collision, we want to make sure the contact knows it's
 	// working with one of the box's face normals (meaning distance is along that normal)
 	vec2 posB = 0.5f*(GetVert( pAABB, vIdx ) + GetVert( pAABB, vIdx + 1 ));
-	//n = glm::normalize( posB - pCirc->v2Center );
-	vec2 posA = pCirc->v2Center + pCirc->circData.fRadius * n;
+	//n = glm::normalize( posB - pCirc->GetCenter() );
+	vec2 posA = pCirc->GetCenter() + pCirc->circData.fRadius * n;
 	float fDist = glm::dot( posB - posA, n );
-	return{ Contact( pCirc, pAABB, posA, posB, n, fDist ) };
+
+	// Face regions are features 0-3
+	vContacts.emplace_back( pCirc, pAABB, posA, posB, n, fDist, vIdx );
+	return 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
-std::list<Contact> GetSpecContacts( Circle * pCirc, OBB * pOBB )
+uint32_t GetSpecContacts( Circle * pCirc, OBB * pOBB, std::vector<Contact>& vContacts, const float fDT ) noexcept
 {
-	vec2 b_pos = pOBB->WorldSpaceClamp( pCirc->v2Center );
-	vec2 n = glm::normalize( b_pos - pCirc->v2Center );
-	vec2 a_pos = pCirc->v2Center + n * pCirc->circData.fRadius;
+	// Don't bother if these two can't reach each other this step
+	if ( IsOutsideSpeculativeMargin( pCirc, pOBB, fDT ) )
+		return 0;
+
+	// If the center is inside the box the clamp doesn't move it,
+	// so push out along the line between the centers instead
+	vec2 b_pos = pOBB->WorldSpaceClamp( pCirc->GetCenter() );
+	vec2 d = b_pos - pCirc->GetCenter();
+	if ( glm::length( d ) < kEPS )
+		d = pOBB->GetCenter() - pCirc->GetCenter();
+	float fLen = glm::length( d );
+	vec2 n = fLen < kEPS ? vec2( 1, 0 ) : glm::normalize( d );
+	vec2 a_pos = pCirc->GetCenter() + n * pCirc->circData.fRadius;
 	
 	float fDist = glm::dot( b_pos - a_pos, n );
 	
 	// Construct and return
-	return{ Contact( pCirc, pOBB, a_pos, b_pos, n, fDist ) };
+	vContacts.emplace_back( pCirc, pOBB, a_pos, b_pos, n, fDist );
+	return 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 bool IsOverlapping( Circle * pA, Circle * pB )
 {
-	float dist = glm::length( pA->v2Center - pB->v2Center );
+	float dist = glm::length( pA->GetCenter() - pB->GetCenter() );
 	float totalRadius = pA->Radius() + pB->Radius();
 
 	return (dist < totalRadius);
@@ -153,7 +181,7 @@ bool IsOverlapping( Circle * pA, Circle * pB )
 bool IsOverlapping( Circle * pCirc, AABB * pAABB )
 {
 	float r = pCirc->Radius();
-	glm::vec2& C = pCirc->v2Center;
+	const glm::vec2& C = pCirc->GetCenter();
 	bool bX = (pAABB->Left() > C.x + r) || (pAABB->Right() < C.y - r) == false;
 	bool bY = (pAABB->Bottom() > C.y + r) || (pAABB->Top() < C.y - r);
 	return bX && bY;
@@ -167,12 +195,12 @@ bool IsOverlapping( Circle * pCirc, OBB * pOBB )
 	for ( int i = 0; i < 4; i++ )
 		if ( IsPointInside( GetVert( pOBB, i ), pCirc ) )
 			return true;
-	return IsPointInside( pCirc->v2Center, pOBB );
+	return IsPointInside( pCirc->GetCenter(), pOBB );
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 bool IsPointInside( vec2 p, Circle * pCirc )
 {
-	return glm::length2( pCirc->v2Center - p ) < powf( pCirc->circData.fRadius, 2 );
+	return glm::length2( pCirc->GetCenter() - p ) < powf( pCirc->circData.fRadius, 2 );
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "CircleBatch.h"
+#include "Glm_Util.h"
+#include "Util.h"
+
+#include <cmath>
+
+// Use SSE if the compiler lets us (it's always there on x64)
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define CIRCLEBATCH_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+// Pairs are processed this many at a time
+const size_t kSimdWidth = 4;
+
+void CircleBatch::resize( const size_t nPairs )
+{
+	// Padding lanes are never emitted, so their contents don't matter
+	const size_t uPadded = kSimdWidth * ( ( nPairs + kSimdWidth - 1 ) / kSimdWidth );
+	for ( std::vector<float> * pArr : { &m_vDX, &m_vDY, &m_vRadSum, &m_vRelVX, &m_vRelVY, &m_vSpin, &m_vNX, &m_vNY, &m_vDist } )
+		pArr->resize( uPadded, 0.f );
+	m_vKeep.resize( uPadded / kSimdWidth );
+}
+
+size_t CircleBatch::GetSpeculativeContacts( const RigidBody2D * pBodies, const std::vector<SweepAndPrune::Pair>& vPairs, std::vector<Contact>& vContacts, const float fDT ) noexcept
+{
+	if ( vPairs.empty() )
+		return 0;
+
+	// Gather pair data
+	resize( vPairs.size() );
+	for ( size_t i = 0; i < vPairs.size(); i++ )
+	{
+		const RigidBody2D& rbA = pBodies[vPairs[i].uIdxA];
+		const RigidBody2D& rbB = pBodies[vPairs[i].uIdxB];
+		const vec2 v2VelA = rbA.fMass > 0 ? rbA.GetVel() : vec2( 0 );
+		const vec2 v2VelB = rbB.fMass > 0 ? rbB.GetVel() : vec2( 0 );
+		const float fSpinA = rbA.fMass > 0 ? fabs( rbA.GetOmega() ) * rbA.circData.fRadius : 0.f;
+		const float fSpinB = rbB.fMass > 0 ? fabs( rbB.GetOmega() ) * rbB.circData.fRadius : 0.f;
+
+		m_vDX[i] = rbB.GetCenter().x - rbA.GetCenter().x;
+		m_vDY[i] = rbB.GetCenter().y - rbA.GetCenter().y;
+		m_vRadSum[i] = rbA.circData.fRadius + rbB.circData.fRadius;
+		m_vRelVX[i] = v2VelB.x - v2VelA.x;
+		m_vRelVY[i] = v2VelB.y - v2VelA.y;
+		m_vSpin[i] = fSpinA + fSpinB;
+	}
+
+	computeContacts( fDT );
+
+	// Emit contacts for the pairs that are close enough
+	size_t nCulled( 0 );
+	for ( size_t i = 0; i < vPairs.size(); i++ )
+	{
+		if ( ( m_vKeep[i / kSimdWidth] & ( 1 << ( i % kSimdWidth ) ) ) == 0 )
+		{
+			nCulled++;
+			continue;
+		}
+
+		// Contact points along the circumferences
+		RigidBody2D * pA = const_cast<RigidBody2D *>( &pBodies[vPairs[i].uIdxA] );
+		RigidBody2D * pB = const_cast<RigidBody2D *>( &pBodies[vPairs[i].uIdxB] );
+		const vec2 n( m_vNX[i], m_vNY[i] );
+		const vec2 a_pos = pA->GetCenter() + n * pA->circData.fRadius;
+		const vec2 b_pos = pB->GetCenter() - n * pB->circData.fRadius;
+		vContacts.emplace_back( pA, pB, a_pos, b_pos, n, m_vDist[i] );
+	}
+
+	return nCulled;
+}
+
+void CircleBatch::computeContacts( const float fDT )
+{
+	// A pair is kept unless the gap between the circles is more than
+	// the distance they could close this step, plus the margin
+	// (this is IsOutsideSpeculativeMargin for two circles)
+#ifdef CIRCLEBATCH_USE_SSE
+	const __m128 vDT = _mm_set1_ps( fDT );
+	const __m128 vMargin = _mm_set1_ps( g_fSpeculativeMargin );
+	const __m128 vOne = _mm_set1_ps( 1.f );
+	const __m128 vEps = _mm_set1_ps( kEPS );
+
+	for ( size_t i = 0; i < m_vDX.size(); i += kSimdWidth )
+	{
+		const __m128 vDX = _mm_loadu_ps( &m_vDX[i] );
+		const __m128 vDY = _mm_loadu_ps( &m_vDY[i] );
+		const __m128 vRelVX = _mm_loadu_ps( &m_vRelVX[i] );
+		const __m128 vRelVY = _mm_loadu_ps( &m_vRelVY[i] );
+
+		// Center distance and the gap between circumferences
+		const __m128 vLen = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( vDX, vDX ), _mm_mul_ps( vDY, vDY ) ) );
+		const __m128 vDist = _mm_sub_ps( vLen, _mm_loadu_ps( &m_vRadSum[i] ) );
+
+		// How far they could close this step
+		const __m128 vSpeed = _mm_add_ps( _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( vRelVX, vRelVX ), _mm_mul_ps( vRelVY, vRelVY ) ) ), _mm_loadu_ps( &m_vSpin[i] ) );
+		const __m128 vReach = _mm_add_ps( _mm_mul_ps( vSpeed, vDT ), vMargin );
+		m_vKeep[i / kSimdWidth] = _mm_movemask_ps( _mm_cmple_ps( vDist, vReach ) );
+
+		// Normalize the center offset, circles on top of each other get +x
+		const __m128 vInvLen = _mm_div_ps( vOne, vLen );
+		const __m128 vDegenerate = _mm_cmplt_ps( vLen, vEps );
+		_mm_storeu_ps( &m_vNX[i], _mm_or_ps( _mm_and_ps( vDegenerate, vOne ), _mm_andnot_ps( vDegenerate, _mm_mul_ps( vDX, vInvLen ) ) ) );
+		_mm_storeu_ps( &m_vNY[i], _mm_andnot_ps( vDegenerate, _mm_mul_ps( vDY, vInvLen ) ) );
+		_mm_storeu_ps( &m_vDist[i], vDist );
+	}
+#else
+	// Same thing, one at a time
+	for ( size_t i = 0; i < m_vDX.size(); i++ )
+	{
+		const float fLen = sqrtf( m_vDX[i] * m_vDX[i] + m_vDY[i] * m_vDY[i] );
+		const float fDist = fLen - m_vRadSum[i];
+		const float fSpeed = sqrtf( m_vRelVX[i] * m_vRelVX[i] + m_vRelVY[i] * m_vRelVY[i] ) + m_vSpin[i];
+		if ( i % kSimdWidth == 0 )
+			m_vKeep[i / kSimdWidth] = 0;
+		if ( fDist <= fSpeed * fDT + g_fSpeculativeMargin )
+			m_vKeep[i / kSimdWidth] |= 1 << ( i % kSimdWidth );
+
+		m_vNX[i] = fLen < kEPS ? 1.f : m_vDX[i] / fLen;
+		m_vNY[i] = fLen < kEPS ? 0.f : m_vDY[i] / fLen;
+		m_vDist[i] = fDist;
+	}
+#endif
+}
@@ -1,13 +1,13 @@
 #include "Contact.h"
 #include "RigidBody2D.h"
 #include "CollisionFunctions.h"
-#include "GL_Util.h"
+#include "Glm_Util.h"
 #include "Util.h"
-#include "Drawable.h"
-#include <glm/vec4.hpp>
-#include <glm/gtc/random.hpp>
+#include "ThreadPool.h"
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
 
 Contact::Contact():
 	m_bIsColliding( false ),
@@ -17,83 +17,94 @@ Contact::Contact():
 	m_v2Normal( vec2() ),
 	m_fDist( 0 ),
 	m_fCurImpulse( 0 ),
-	m_fInvMassI(0)
+	m_fBounceImpulse( 0 ),
+	m_fInvMassI(0),
+	m_uFeatureID( 0 )
 {}
 
-Contact::Contact( RigidBody2D * pA, RigidBody2D * pB, const vec2 posA, const vec2 posB, const vec2 nrm, const float d ) :
+Contact::Contact( RigidBody2D * pA, RigidBody2D * pB, const vec2 posA, const vec2 posB, const vec2 nrm, const float d, const uint32_t uFeatureID /*= 0*/ ) noexcept :
 	m_bIsColliding( false ),
 	m_pCollidingPair{ pA, pB },
 	m_v2Pos{ posA, posB },
 	m_v2Normal( nrm ),
 	m_fDist( d ),
-	m_fCurImpulse( 0 )
+	m_fCurImpulse( 0 ),
+	m_fBounceImpulse( 0 ),
+	m_uFeatureID( uFeatureID )
 {
-	// How should I handle this?
-	if ( pA == pB )
-		throw std::runtime_error( "Error: Contact created from one object!" );
-
 	// Find the inverse denom
 	float fDenom( 0.f );
 	for ( size_t i = 0; i < 2; i++ )
 	{
-		// Skip anything with a negative mass
-		if ( m_pCollidingPair[i]->fMass < 0 )
-			continue;
-
 		// The radius arm is the vector from the object's center to the contact
-		m_v2Radius[i] = perp( m_v2Pos[i] - m_pCollidingPair[i]->v2Center );
+		m_v2Radius[i] = perp( m_v2Pos[i] - m_pCollidingPair[i]->GetCenter() );
 
 		// The inverse mass denominator is a coeffecient used to calculate impulses
-		// and depends on the object's inertia intertia, and it has a translation/rotation component
-		fDenom += 1.f / m_pCollidingPair[i]->fMass;
-
-		// Right now OBB is the only primitive that rotates
-		//if ( m_pCollidingPair[i]->eType == RigidBody2D::EType::OBB )
-		{
-			float rN = glm::dot( m_v2Radius[i], m_v2Normal );
-			fDenom += powf( rN, 2 ) / m_pCollidingPair[i]->GetInertia();
-		}
+		// and depends on the object's inertia intertia, and it has a translation/rotation component.
+		// Static bodies have zero inverse mass and inertia, so they add nothing
+		float rN = glm::dot( m_v2Radius[i], m_v2Normal );
+		fDenom += m_pCollidingPair[i]->fInvMass + rN * rN * m_pCollidingPair[i]->fInvInertia;
 	}
 	
-	// Is this necessary?
-	if ( fDenom < kEPS )
-		throw std::runtime_error( "Error: Invalid inertial denominator calculated!" );
-
-	// Set the inverse mass denom
-	m_fInvMassI = 1.f / fDenom;
+	// Scene::AddRigidBody rejects the bodies that could get us here
+	// (zero mass, bad dimensions, NaNs) and the broadphase never pairs a
+	// body with itself or two statics, but if it happens anyway the
+	// contact gets no impulse rather than throwing out of the step
+	m_fInvMassI = fDenom >= kEPS ? 1.f / fDenom : 0.f;
 }
 
-void Contact::ApplyImpulse( float fMag )
+void Contact::ApplyImpulse( float fMag, float fBounce /*= 0.f*/ )
 {
-	// Calculate the new impulse and apply the change
+	// Calculate the new impulse and apply the change. The running
+	// total is clamped, so the contact can only ever push the pair apart
 	float newImpulse = std::min( 0.f, fMag + m_fCurImpulse );
 	float delImpulse = newImpulse - m_fCurImpulse;
 
 	// Find the direction along our collision normal
 	vec2 v2Impulse = delImpulse * m_v2Normal;
 
-	float k0 = m_pA->GetKineticEnergy() + m_pB->GetKineticEnergy();
-
-	for ( int i = 0; i < 2; i++ )
+	// Apply it to A and the opposite to B. Static bodies have zero inverse
+	// mass and inertia so they wouldn't move anyway, but they're shared
+	// between islands solved on different threads so never write to them
+	if ( m_pA->fMass > 0 )
 	{
-		// Skip anything with a negative mass
-		if ( m_pCollidingPair[i]->fMass < 0 )
-			continue;
-
-		const float sgn = i == 0 ? 1.f : -1.f;
-		m_pCollidingPair[i]->v2Vel += sgn * v2Impulse / m_pCollidingPair[i]->fMass;
-		m_pCollidingPair[i]->fOmega += sgn * glm::dot(v2Impulse, m_v2Radius[i]) / m_pCollidingPair[i]->GetInertia();
+		m_pA->SetVel( m_pA->GetVel() + m_pA->fInvMass * v2Impulse );
+		m_pA->SetOmega( m_pA->GetOmega() + m_pA->fInvInertia * glm::dot( v2Impulse, m_v2Radius[0] ) );
+	}
+	if ( m_pB->fMass > 0 )
+	{
+		m_pB->SetVel( m_pB->GetVel() - m_pB->fInvMass * v2Impulse );
+		m_pB->SetOmega( m_pB->GetOmega() - m_pB->fInvInertia * glm::dot( v2Impulse, m_v2Radius[1] ) );
 	}
 
-	float k1 = m_pA->GetKineticEnergy() + m_pB->GetKineticEnergy();
-
-	// Add impulse to local var
+	// Add impulse to local var, the bounce can't be more than all of it
 	m_fCurImpulse = newImpulse;
+	m_fBounceImpulse = clamp( m_fBounceImpulse + fBounce, newImpulse, 0.f );
+}
+
+bool Contact::WarmStart( float fImpulse, const float fInvDT )
+{
+	// If the solver wouldn't touch this contact then the pair isn't
+	// about to collide, and pushing on it would only add energy
+	// (this is the solver's test, written so that a degenerate contact fails it)
+	float fRelVN = GetVelN_B() - GetVelN_A();
+	if ( ( fRelVN + m_fDist * fInvDT < kEPS ) == false )
+		return false;
+
+	// Push with last step's impulse, but no harder than it takes to stop the
+	// pair approaching. Nothing keeps pushing bodies together between steps, so
+	// anything more is left over from an impact that's already been resolved.
+	// The bounce goes with however much of the approach that stopped, the
+	// solver bounces whatever is left, so restitution is never counted twice
+	const float fStop = std::max( fImpulse, std::min( fRelVN, 0.f ) * m_fInvMassI );
+	const float fBounce = GetAvgCoefRest() * fStop;
+	ApplyImpulse( fStop + fBounce, fBounce );
+	return true;
 }
 
 vec2 Contact::getContactVel( int i ) const
 {
-	return m_pCollidingPair[i]->v2Vel + m_v2Radius[i] * m_pCollidingPair[i]->fOmega;
+	return m_pCollidingPair[i]->GetVel() + m_v2Radius[i] * m_pCollidingPair[i]->GetOmega();
 }
 
 vec2 Contact::GetVel_A() const
@@ -136,6 +147,21 @@ float Contact::GetCurImpulse() const
 	return m_fCurImpulse;
 }
 
+float Contact::GetNormalImpulse() const
+{
+	return m_fCurImpulse - m_fBounceImpulse;
+}
+
+uint32_t Contact::GetFeatureID() const
+{
+	return m_uFeatureID;
+}
+
+glm::vec2 Contact::GetNormal() const
+{
+	return m_v2Normal;
+}
+
 const RigidBody2D * Contact::GetBodyA() const
 {
 	return m_pA;
@@ -158,55 +184,108 @@ void Contact::setIsColliding( bool bColliding )
 
 // Contact Solver
 Contact::Solver::Solver():
-	m_nIterations(0)
+	m_nIterations( 0 ),
+	m_eMode( EMode::Serial ),
+	m_pThreadPool( nullptr ),
+	m_fInvTimeStep( 1.f / kDefaultTimeStep )
 {}
 
 Contact::Solver::Solver( uint32_t nIterations ) :
-	m_nIterations( nIterations )
+	m_nIterations( nIterations ),
+	m_eMode( EMode::Serial ),
+	m_pThreadPool( nullptr ),
+	m_fInvTimeStep( 1.f / kDefaultTimeStep )
 {}
 
-uint32_t Contact::Solver::Solve( std::list<Contact>& liContacts )
+void Contact::Solver::SetMode( EMode eMode )
+{
+	m_eMode = eMode;
+}
+
+Contact::Solver::EMode Contact::Solver::GetMode() const
 {
+	return m_eMode;
+}
+
+void Contact::Solver::SetThreadPool( ThreadPool * pThreadPool )
+{
+	m_pThreadPool = pThreadPool;
+}
+
+void Contact::Solver::SetTimeStep( const float fDT )
+{
+	m_fInvTimeStep = 1.f / fDT;
+}
+
+/*static*/ bool Contact::Solver::solveContact( Contact& c, const float fInvDT )
+{
+	// Coeffcicient of restitution, plus 1
+	const float fCr_1 = 1.f + c.GetAvgCoefRest();
+
+	// Get the relative velocity of each body along the contact normal
+	const float vA_N = c.GetVelN_A();
+	const float vB_N = c.GetVelN_B();
+
+	// Find the relative velocity of the system
+	float fRelVN = vB_N - vA_N;
+
+	// Determine how much velocity we'd need to remove such that
+	// in the next iteration the two objects will be touching
+	float fVelNeeded = c.GetDistance() * fInvDT;
+	float fVelToRemove = fRelVN + fVelNeeded;
+
+	// If this is very low
+	if ( fVelToRemove < kEPS )
+	{
+		// apply a collison along the normal. The restitution part, and the
+		// push given to pairs that are still overlapping, only make sense
+		// for this step, so they're kept apart and never warm started
+		float impulseMag = fCr_1 * fRelVN * c.GetInertialDenom();
+		float fBounce = impulseMag - fRelVN * c.GetInertialDenom();
+		if ( c.GetDistance() < 0 && fRelVN > 0 && c.GetBodyA()->fMass > 0 && c.GetBodyB()->fMass > 0 )
+		{
+			impulseMag = -(.05f * c.GetInertialDenom());
+			fBounce = impulseMag;
+		}
+		c.ApplyImpulse( impulseMag, fBounce );
+
+		// Flag contact as colliding
+		c.setIsColliding( true );
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t Contact::Solver::Solve( std::vector<Contact>& vContacts, uint32_t * pnIterationsUsed /*= nullptr*/ ) const
+{
+	return Solve( vContacts.data(), vContacts.size(), pnIterationsUsed );
+}
+
+uint32_t Contact::Solver::Solve( Contact * pContacts, const size_t nContacts, uint32_t * pnIterationsUsed /*= nullptr*/ ) const
+{
+	if ( m_eMode == EMode::Colored )
+		return solveColored( pContacts, nContacts, pnIterationsUsed );
+
 	// Return the # of collisions
 	uint32_t uNumCollisions( 0 );
 
 	// Iterate and solve contacts
-	for ( int nIt = 0; nIt < m_nIterations; nIt++ )
+	uint32_t nIt = 0;
+	while ( nIt < m_nIterations )
 	{
+		// Count this iteration even if nothing collides
+		nIt++;
+
 		// The # of collisions this iteration
 		uint32_t uColCount = 0;
 
 		// Walk the contacts
-		for ( Contact& c : liContacts )
+		for ( size_t i = 0; i < nContacts; i++ )
 		{
-			// Coeffcicient of restitution, plus 1
-			const float fCr_1 = 1.f + c.GetAvgCoefRest();
-
-			// Get the relative velocity of each body along the contact normal
-			const float vA_N = c.GetVelN_A();
-			const float vB_N = c.GetVelN_B();
-
-			// Find the relative velocity of the system
-			float fRelVN = vB_N - vA_N;
-
-			// Determine how much velocity we'd need to remove such that
-			// in the next iteration the two objects will be touching
-			float fVelNeeded = c.GetDistance() * g_fInvTimeStep;
-			float fVelToRemove = fRelVN + fVelNeeded;
-
-			// If this is very low
-			if ( fVelToRemove < kEPS )
-			{
-				// apply a collison along the normal
-				float impulseMag = fCr_1 * fRelVN * c.GetInertialDenom();
-				if ( c.GetDistance() < 0 && fRelVN > 0 && c.GetBodyA()->fMass > 0 && c.GetBodyB()->fMass > 0 )
-					impulseMag = -(.05f * c.GetInertialDenom());
-				c.ApplyImpulse( impulseMag );
-
-				// Increase collision counter, flag contact as colliding
+			// Increase collision counter if we applied an impulse
+			if ( solveContact( pContacts[i], m_fInvTimeStep ) )
 				uColCount++;
-				c.setIsColliding( true );
-			}
 		}
 
 		// Maybe break if no contacts are colliding
@@ -217,20 +296,122 @@ uint32_t Contact::Solver::Solve( std::list<Contact>& liContacts )
 			uNumCollisions += uColCount;
 	}
 
+	if ( pnIterationsUsed )
+		*pnIterationsUsed = nIt;
+
 	return uNumCollisions;
 }
 
-void Contact::InitDrawable( std::array<Drawable *, 2> drPtrArr ) const
+// Colors a body can take part in, contacts that find no free color go in one last serial batch
+const uint32_t kMaxColors = 64;
+
+// Contacts per task when a batch is spread across the pool
+const size_t kColorChunkSize = 64;
+
+uint32_t Contact::Solver::solveColored( Contact * pContacts, const size_t nContacts, uint32_t * pnIterationsUsed ) const
 {
-	const float drScale = 0.2f;
-	vec4 v4Color = glm::linearRand( vec4( vec3( 0.3 ), 1 ), vec4( 1 ) );
-	for ( int i = 0; i < 2; i++ )
+	if ( pnIterationsUsed )
+		*pnIterationsUsed = 0;
+
+	if ( nContacts == 0 )
+		return 0;
+
+	// Find the range of bodies these contacts touch, so colors can be tracked per body
+	const RigidBody2D * pFirst = pContacts[0].m_pA, * pLast = pContacts[0].m_pA;
+	for ( size_t i = 0; i < nContacts; i++ )
 	{
-		if ( drPtrArr[i] )
+		for ( const RigidBody2D * pRB : pContacts[i].m_pCollidingPair )
 		{
-			quatvec qv; 
-			qv.vec = vec3( m_v2Pos[i], 1.f );
-			drPtrArr[i]->Init( "../models/quad.iqm", v4Color, qv, vec2( drScale ) );
+			pFirst = std::min( pFirst, pRB );
+			pLast = std::max( pLast, pRB );
 		}
 	}
+
+	// Greedily give each contact the lowest color neither of its dynamic
+	// bodies has used. Static bodies don't move, so they can be in every batch
+	m_vBodyColors.assign( pLast - pFirst + 1, 0 );
+	m_vContactColors.resize( nContacts );
+	m_vColorOffsets.assign( kMaxColors + 2, 0 );
+	for ( size_t i = 0; i < nContacts; i++ )
+	{
+		uint64_t uUsed( 0 );
+		for ( const RigidBody2D * pRB : pContacts[i].m_pCollidingPair )
+			if ( pRB->fMass > 0 )
+				uUsed |= m_vBodyColors[pRB - pFirst];
+
+		uint32_t uColor( 0 );
+		while ( uColor < kMaxColors && ( ( uUsed >> uColor ) & 1 ) )
+			uColor++;
+
+		if ( uColor < kMaxColors )
+			for ( const RigidBody2D * pRB : pContacts[i].m_pCollidingPair )
+				if ( pRB->fMass > 0 )
+					m_vBodyColors[pRB - pFirst] |= uint64_t( 1 ) << uColor;
+
+		m_vContactColors[i] = (uint8_t) uColor;
+		m_vColorOffsets[uColor + 1]++;
+	}
+
+	// Sort contact indices into color batches, keeping their order within each
+	for ( uint32_t uColor = 0; uColor <= kMaxColors; uColor++ )
+		m_vColorOffsets[uColor + 1] += m_vColorOffsets[uColor];
+
+	std::vector<uint32_t> vCursor( m_vColorOffsets.begin(), m_vColorOffsets.end() - 1 );
+	m_vColoredContacts.resize( nContacts );
+	for ( size_t i = 0; i < nContacts; i++ )
+		m_vColoredContacts[vCursor[m_vContactColors[i]]++] = (uint32_t) i;
+
+	// Solves a chunk of the current batch, made once so iterations don't allocate
+	size_t uBatchBegin( 0 ), uBatchEnd( 0 );
+	std::atomic<uint32_t> uColCount( 0 );
+	const std::function<void( size_t )> fnSolveChunk = [&] ( size_t uChunk )
+	{
+		const size_t uBegin = uBatchBegin + uChunk * kColorChunkSize;
+		const size_t uEnd = std::min( uBatchEnd, uBegin + kColorChunkSize );
+		uint32_t uChunkCount( 0 );
+		for ( size_t i = uBegin; i < uEnd; i++ )
+			if ( solveContact( pContacts[m_vColoredContacts[i]], m_fInvTimeStep ) )
+				uChunkCount++;
+		uColCount += uChunkCount;
+	};
+
+	// Iterate as the serial solver does, walking one batch at a time
+	uint32_t uNumCollisions( 0 );
+	uint32_t nIt = 0;
+	while ( nIt < m_nIterations )
+	{
+		nIt++;
+		uColCount = 0;
+
+		for ( uint32_t uColor = 0; uColor <= kMaxColors; uColor++ )
+		{
+			uBatchBegin = m_vColorOffsets[uColor];
+			uBatchEnd = m_vColorOffsets[uColor + 1];
+			if ( uBatchBegin == uBatchEnd )
+				continue;
+
+			// The overflow batch may share bodies, so it has to stay serial
+			const size_t nChunks = ( uBatchEnd - uBatchBegin + kColorChunkSize - 1 ) / kColorChunkSize;
+			if ( m_pThreadPool && uColor < kMaxColors )
+				m_pThreadPool->ParallelFor( nChunks, fnSolveChunk );
+			else
+				for ( size_t uChunk = 0; uChunk < nChunks; uChunk++ )
+					fnSolveChunk( uChunk );
+		}
+
+		if ( uColCount == 0 )
+			break;
+		else
+			uNumCollisions += uColCount;
+	}
+
+	if ( pnIterationsUsed )
+		*pnIterationsUsed = nIt;
+
+	return uNumCollisions;
+}
+
+glm::vec2 Contact::GetPosition( int i ) const
+{
+	return m_v2Pos[i];
 }
\ No newline at end of file
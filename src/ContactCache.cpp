@@ -0,0 +1,97 @@
+#include "ContactCache.h"
+
+#include <algorithm>
+
+ContactCache::ContactCache() :
+	m_fWarmStartFactor( 1.f )
+{}
+
+/*static*/ uint64_t ContactCache::GetKey( const Contact& c, const RigidBody2D * pBodies )
+{
+	// 24 bits for each body index and 16 for the feature
+	const uint64_t uIdxA = (uint64_t) ( c.GetBodyA() - pBodies ) & 0xFFFFFF;
+	const uint64_t uIdxB = (uint64_t) ( c.GetBodyB() - pBodies ) & 0xFFFFFF;
+	return ( uIdxA << 40 ) | ( uIdxB << 16 ) | ( c.GetFeatureID() & 0xFFFF );
+}
+
+size_t ContactCache::WarmStart( std::vector<Contact>& vContacts, const RigidBody2D * pBodies, const float fInvDT ) const
+{
+	if ( m_vEntries.empty() || m_fWarmStartFactor <= 0 )
+		return 0;
+
+	size_t uNumWarmStarted( 0 );
+	for ( Contact& c : vContacts )
+	{
+		// Binary search for the contact's key
+		const uint64_t uKey = GetKey( c, pBodies );
+		auto it = std::lower_bound( m_vEntries.begin(), m_vEntries.end(), uKey,
+									[] ( const Entry& e, const uint64_t k ) { return e.uKey < k; } );
+		if ( it == m_vEntries.end() || it->uKey != uKey )
+			continue;
+
+		if ( c.WarmStart( m_fWarmStartFactor * it->fImpulse, fInvDT ) )
+			uNumWarmStarted++;
+	}
+
+	return uNumWarmStarted;
+}
+
+void ContactCache::Store( const std::vector<Contact>& vContacts, const RigidBody2D * pBodies )
+{
+	// The vector keeps its storage between steps
+	m_vEntries.clear();
+	for ( const Contact& c : vContacts )
+	{
+		// Nothing to remember for contacts that never pushed. The bounce isn't
+		// kept, reapplying it next step would only throw the pair apart again
+		if ( c.GetNormalImpulse() != 0 )
+			m_vEntries.push_back( { GetKey( c, pBodies ), c.GetNormalImpulse() } );
+	}
+
+	std::sort( m_vEntries.begin(), m_vEntries.end(),
+			   [] ( const Entry& a, const Entry& b ) { return a.uKey < b.uKey; } );
+}
+
+void ContactCache::Clear()
+{
+	m_vEntries.clear();
+}
+
+size_t ContactCache::GetSize() const
+{
+	return m_vEntries.size();
+}
+
+void ContactCache::SaveSnapshot( SnapshotWriter& writer ) const
+{
+	writer.Write( (uint32_t) m_vEntries.size() );
+	writer.Write( m_vEntries.data(), m_vEntries.size() );
+}
+
+bool ContactCache::LoadSnapshot( SnapshotReader& reader )
+{
+	uint32_t uNumEntries( 0 );
+	if ( reader.Read( uNumEntries ) == false || uNumEntries > reader.GetRemaining() / sizeof( Entry ) )
+		return false;
+
+	std::vector<Entry> vEntries( uNumEntries );
+	if ( reader.Read( vEntries.data(), vEntries.size() ) == false )
+		return false;
+
+	// WarmStart binary searches these
+	if ( std::is_sorted( vEntries.begin(), vEntries.end(), [] ( const Entry& a, const Entry& b ) { return a.uKey < b.uKey; } ) == false )
+		return false;
+
+	m_vEntries.swap( vEntries );
+	return true;
+}
+
+void ContactCache::SetWarmStartFactor( const float fFactor )
+{
+	m_fWarmStartFactor = fFactor;
+}
+
+float ContactCache::GetWarmStartFactor() const
+{
+	return m_fWarmStartFactor;
+}
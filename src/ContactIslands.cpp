@@ -0,0 +1,116 @@
+#include "ContactIslands.h"
+
+#include <algorithm>
+#include <numeric>
+
+uint32_t ContactIslands::find( uint32_t uIdx )
+{
+	// Path halving keeps the trees flat
+	while ( m_vParent[uIdx] != uIdx )
+	{
+		m_vParent[uIdx] = m_vParent[m_vParent[uIdx]];
+		uIdx = m_vParent[uIdx];
+	}
+	return uIdx;
+}
+
+size_t ContactIslands::Build( std::vector<Contact>& vContacts, const RigidBody2D * pBodies, const size_t nBodies )
+{
+	// Every body starts out on its own
+	m_vParent.resize( nBodies );
+	std::iota( m_vParent.begin(), m_vParent.end(), 0 );
+
+	// Join the dynamic bodies of each contact
+	for ( const Contact& c : vContacts )
+	{
+		const RigidBody2D * pA = c.GetBodyA();
+		const RigidBody2D * pB = c.GetBodyB();
+		if ( pA->fMass > 0 && pB->fMass > 0 )
+		{
+			uint32_t uRootA = find( (uint32_t) ( pA - pBodies ) );
+			uint32_t uRootB = find( (uint32_t) ( pB - pBodies ) );
+			if ( uRootA != uRootB )
+				m_vParent[std::max( uRootA, uRootB )] = std::min( uRootA, uRootB );
+		}
+	}
+
+	// Number the roots as they come up and find each contact's island
+	// (the broadphase never pairs two static bodies, so one side is dynamic)
+	m_vRootIsland.assign( nBodies, -1 );
+	m_vContactIsland.resize( vContacts.size() );
+	std::vector<uint32_t> vIslandSizes;
+	for ( size_t i = 0; i < vContacts.size(); i++ )
+	{
+		const RigidBody2D * pDynamic = vContacts[i].GetBodyA()->fMass > 0 ? vContacts[i].GetBodyA() : vContacts[i].GetBodyB();
+		const uint32_t uRoot = find( (uint32_t) ( pDynamic - pBodies ) );
+		if ( m_vRootIsland[uRoot] < 0 )
+		{
+			m_vRootIsland[uRoot] = (int) vIslandSizes.size();
+			vIslandSizes.push_back( 0 );
+		}
+
+		m_vContactIsland[i] = m_vRootIsland[uRoot];
+		vIslandSizes[m_vContactIsland[i]]++;
+	}
+
+	// Put the big islands first, so the thread pool starts on them
+	const size_t nIslands = vIslandSizes.size();
+	std::vector<uint32_t> vOrder( nIslands ), vRank( nIslands );
+	std::iota( vOrder.begin(), vOrder.end(), 0 );
+	std::stable_sort( vOrder.begin(), vOrder.end(), [&vIslandSizes] ( uint32_t a, uint32_t b )
+	{
+		return vIslandSizes[a] > vIslandSizes[b];
+	} );
+
+	m_vIslandOffsets.resize( nIslands + 1 );
+	m_vIslandOffsets[0] = 0;
+	for ( size_t i = 0; i < nIslands; i++ )
+	{
+		vRank[vOrder[i]] = (uint32_t) i;
+		m_vIslandOffsets[i + 1] = m_vIslandOffsets[i] + vIslandSizes[vOrder[i]];
+	}
+
+	// Scatter the contacts into their island's range
+	std::vector<uint32_t> vCursor( m_vIslandOffsets.begin(), m_vIslandOffsets.end() - 1 );
+	m_vScratch.resize( vContacts.size() );
+	for ( size_t i = 0; i < vContacts.size(); i++ )
+		m_vScratch[vCursor[vRank[m_vContactIsland[i]]]++] = vContacts[i];
+	vContacts.swap( m_vScratch );
+
+	// Now give every dynamic body its root's (sorted) island
+	m_vBodyIsland.resize( nBodies );
+	for ( size_t i = 0; i < nBodies; i++ )
+	{
+		if ( pBodies[i].fMass > 0 )
+		{
+			const int iIsland = m_vRootIsland[find( (uint32_t) i )];
+			m_vBodyIsland[i] = iIsland < 0 ? -1 : (int) vRank[iIsland];
+		}
+		else
+			m_vBodyIsland[i] = -1;
+	}
+
+	return nIslands;
+}
+
+size_t ContactIslands::GetNumIslands() const
+{
+	return m_vIslandOffsets.empty() ? 0 : m_vIslandOffsets.size() - 1;
+}
+
+size_t ContactIslands::GetIslandBegin( const size_t i ) const
+{
+	return m_vIslandOffsets[i];
+}
+
+size_t ContactIslands::GetIslandSize( const size_t i ) const
+{
+	return m_vIslandOffsets[i + 1] - m_vIslandOffsets[i];
+}
+
+int ContactIslands::GetBodyIsland( const size_t rbIdx ) const
+{
+	if ( rbIdx < m_vBodyIsland.size() )
+		return m_vBodyIsland[rbIdx];
+	return -1;
+}
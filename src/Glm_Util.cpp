@@ -1,4 +1,4 @@
-#include "GL_Util.h"
+#include "Glm_Util.h"
 #include <iostream>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
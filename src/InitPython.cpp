@@ -38,12 +38,54 @@ bool ExposeScene()
 	AddMemFnToMod( pModDef, Scene, GetShaderPtr, const Shader * );
 	AddMemFnToMod( pModDef, Scene, GetCameraPtr, const Camera * );
 	AddMemFnToMod( pModDef, Scene, GetSoundManagerPtr, const SoundManager * );
+	AddMemFnToMod( pModDef, Scene, GetBatchRunnerPtr, const BatchRunner * );
 	AddMemFnToMod( pModDef, Scene, GetDrawable, const Drawable *, size_t );
 	AddMemFnToMod( pModDef, Scene, GetRigidBody2D, const RigidBody2D *, size_t );
 	AddMemFnToMod( pModDef, Scene, GetContacts, std::list<const Contact *> );
+	AddMemFnToMod( pModDef, Scene, GetCollisionEvents, const std::vector<PhysicsWorld::CollisionEvent>& );
+	AddMemFnToMod( pModDef, Scene, ClearCollisionEvents, void );
+	AddMemFnToMod( pModDef, Scene, ResetCollisionCounts, void );
+	AddMemFnToMod( pModDef, Scene, GetCollisionCount, uint32_t, int );
+	AddMemFnToMod( pModDef, Scene, GetCollisionCounts, std::vector<uint32_t> );
+	AddMemFnToMod( pModDef, Scene, GetMostCollidedID, int );
+	AddMemFnToMod( pModDef, Scene, GetNumCandidatePairs, size_t );
+	AddMemFnToMod( pModDef, Scene, GetNumCulledContacts, size_t );
+	AddMemFnToMod( pModDef, Scene, GetSolverIterations, uint32_t );
+	AddMemFnToMod( pModDef, Scene, GetNumIslands, size_t );
+	AddMemFnToMod( pModDef, Scene, GetStats, PhysicsWorld::Stats );
+	AddMemFnToMod( pModDef, Scene, GetSolverMode, Contact::Solver::EMode );
+	AddMemFnToMod( pModDef, Scene, SetSolverMode, void, Contact::Solver::EMode );
+	AddMemFnToMod( pModDef, Scene, GetNumAwakeBodies, size_t );
+	AddMemFnToMod( pModDef, Scene, GetNumSleepingBodies, size_t );
+	AddMemFnToMod( pModDef, Scene, GetAllowSleep, bool );
+	AddMemFnToMod( pModDef, Scene, SetAllowSleep, void, bool );
+	AddMemFnToMod( pModDef, Scene, WakeRigidBody, bool, size_t );
+	AddMemFnToMod( pModDef, Scene, SetCollisionFilter, bool, size_t, uint32_t, uint32_t );
+	AddMemFnToMod( pModDef, Scene, GetCollisionCategory, uint32_t, size_t );
+	AddMemFnToMod( pModDef, Scene, GetCollisionMask, uint32_t, size_t );
+	AddMemFnToMod( pModDef, Scene, WakeAll, void );
+	AddMemFnToMod( pModDef, Scene, QueryPoints, std::vector<SpatialQuery::Hit>, std::vector<float>, uint32_t );
+	AddMemFnToMod( pModDef, Scene, QueryBoxes, std::vector<SpatialQuery::Hit>, std::vector<float>, uint32_t );
+	AddMemFnToMod( pModDef, Scene, QueryRays, std::vector<SpatialQuery::Hit>, std::vector<float>, uint32_t );
+	AddMemFnToMod( pModDef, Scene, RefreshSpatialQuery, void );
+	AddMemFnToMod( pModDef, Scene, GetTimeStep, float );
+	AddMemFnToMod( pModDef, Scene, SetTimeStep, bool, float );
+	AddMemFnToMod( pModDef, Scene, GetMaxSubsteps, uint32_t );
+	AddMemFnToMod( pModDef, Scene, SetMaxSubsteps, void, uint32_t );
+	AddMemFnToMod( pModDef, Scene, GetNumSubsteps, uint32_t );
+	AddMemFnToMod( pModDef, Scene, GetInterpolationAlpha, float );
+	AddMemFnToMod( pModDef, Scene, GetInterpolatedQuatVec, quatvec, size_t );
+	AddMemFnToMod( pModDef, Scene, GetWarmStartFactor, float );
+	AddMemFnToMod( pModDef, Scene, SetWarmStartFactor, void, float );
+	AddMemFnToMod( pModDef, Scene, SaveSnapshot, bool, std::string );
+	AddMemFnToMod( pModDef, Scene, LoadSnapshot, bool, std::string );
 
 	AddMemFnToMod( pModDef, Scene, AddDrawable, int, std::string, vec2, vec2, vec4 );
 	AddMemFnToMod( pModDef, Scene, AddRigidBody, int, RigidBody2D::EType, vec2, vec2, float, float, std::map<std::string, float> );
+	AddMemFnToMod( pModDef, Scene, BindDrawable, bool, size_t, size_t );
+	AddMemFnToMod( pModDef, Scene, UnbindDrawable, bool, size_t );
+	AddMemFnToMod( pModDef, Scene, ClearDrawableBindings, void );
+	AddMemFnToMod( pModDef, Scene, SyncDrawables, void );
 
 	AddMemFnToMod( pModDef, Scene, GetQuitFlag, bool );
 	AddMemFnToMod( pModDef, Scene, SetQuitFlag, void, bool );
@@ -53,8 +95,23 @@ bool ExposeScene()
 	AddMemFnToMod( pModDef, Scene, SetDrawContacts, void, bool );
 
 	AddMemFnToMod( pModDef, Scene, Update, void );
+	AddMemFnToMod( pModDef, Scene, Step, void );
 	AddMemFnToMod( pModDef, Scene, Draw, void );
 
+	pModDef->SetCustomModuleInit( [] ( pyl::Object obModule )
+	{
+		obModule.set_attr( "smSerial", Contact::Solver::EMode::Serial );
+		obModule.set_attr( "smColored", Contact::Solver::EMode::Colored );
+
+		// struct format of one record in GetCollisionEvents' buffer:
+		// idA, idB, impulse, normal x, normal y, point x, point y
+		obModule.set_attr( "CollisionEventFormat", std::string( "=iifffff" ) );
+
+		// struct format of one hit from QueryPoints, QueryBoxes and QueryRays:
+		// query index, body index, id, distance along the ray
+		obModule.set_attr( "QueryHitFormat", std::string( "=IIif" ) );
+	} );
+
 	return true;
 }
 
@@ -281,6 +338,31 @@ bool ExposeContact()
 	return true;
 }
 
+bool ExposeBatchRunner()
+{
+	const std::string strModuleName = "pylBatchRunner";
+
+	ModuleDef * pModDef = ModuleDef::Create<struct st_brMod>( strModuleName );
+	if ( pModDef == nullptr )
+		return false;
+
+	pModDef->RegisterClass<BatchRunner>( "BatchRunner" );
+
+	AddMemFnToMod( pModDef, BatchRunner, AddWorld, size_t );
+	AddMemFnToMod( pModDef, BatchRunner, AddRigidBody, int, size_t, RigidBody2D::EType, vec2, vec2, float, float, std::map<std::string, float> );
+	AddMemFnToMod( pModDef, BatchRunner, LoadSceneFile, int, size_t, std::string );
+	AddMemFnToMod( pModDef, BatchRunner, GetNumWorlds, size_t );
+	AddMemFnToMod( pModDef, BatchRunner, Clear, void );
+	AddMemFnToMod( pModDef, BatchRunner, SetNumThreads, void, size_t );
+	AddMemFnToMod( pModDef, BatchRunner, GetNumThreads, size_t );
+	AddMemFnToMod( pModDef, BatchRunner, Run, void, uint32_t );
+	AddMemFnToMod( pModDef, BatchRunner, GetBodyOffsets, std::vector<uint32_t> );
+	AddMemFnToMod( pModDef, BatchRunner, GetPositions, std::vector<float> );
+	AddMemFnToMod( pModDef, BatchRunner, GetCollisionCounts, std::vector<uint32_t> );
+
+	return true;
+}
+
 bool ExposeAll()
 {
 	// I just wanted to try a polymorphic lambda
@@ -292,7 +374,8 @@ bool ExposeAll()
 		ExposeCamera,
 		ExposeDrawable,
 		ExposeRigidBody2D,
-		ExposeContact
+		ExposeContact,
+		ExposeBatchRunner
 	};
 	return std::all_of( liExpose.begin(), liExpose.end(), [] ( auto fn ) { return fn(); } );
 }
@@ -344,6 +427,16 @@ namespace pyl
 		return convertEnum<SoundManager::ECommandID>( o, e );
 	}
 
+	bool convert( PyObject * o, Contact::Solver::EMode& e )
+	{
+		return convertEnum<Contact::Solver::EMode>( o, e );
+	}
+
+	PyObject * alloc_pyobject( const Contact::Solver::EMode e )
+	{
+		return PyLong_FromLong( (long) e );
+	}
+
 	PyObject * alloc_pyobject( const SoundManager::ECommandID e )
 	{
 		return PyLong_FromLong( (long) e );
@@ -369,4 +462,47 @@ namespace pyl
 		}
 		return nullptr;
 	}
+
+	// The events are copied into bytes the script owns, since the buffer they're in is
+	// refilled by every Update. Unpacked with pylScene.CollisionEventFormat
+	static_assert( sizeof( PhysicsWorld::CollisionEvent ) == 2 * sizeof( int32_t ) + 5 * sizeof( float ), "CollisionEventFormat is out of date" );
+	PyObject * alloc_pyobject( const std::vector<PhysicsWorld::CollisionEvent>& vEvents )
+	{
+		return PyBytes_FromStringAndSize( (const char *) vEvents.data(), vEvents.size() * sizeof( PhysicsWorld::CollisionEvent ) );
+	}
+
+	// The hits belong to the script once they're returned, so they're copied into bytes
+	static_assert( sizeof( SpatialQuery::Hit ) == 3 * sizeof( uint32_t ) + sizeof( float ), "QueryHitFormat is out of date" );
+	PyObject * alloc_pyobject( const std::vector<SpatialQuery::Hit>& vHits )
+	{
+		return PyBytes_FromStringAndSize( (const char *) vHits.data(), vHits.size() * sizeof( SpatialQuery::Hit ) );
+	}
+
+	// A dict, so scripts can pick out what they want by name
+	PyObject * alloc_pyobject( const PhysicsWorld::Stats& stats )
+	{
+		if ( PyObject * pDict = PyDict_New() )
+		{
+			auto setItem = [pDict] ( const char * szKey, PyObject * pVal )
+			{
+				PyDict_SetItemString( pDict, szKey, pVal );
+				Py_XDECREF( pVal );
+			};
+
+			setItem( "substeps", PyLong_FromUnsignedLong( stats.nSubsteps ) );
+			setItem( "broadphasePairs", PyLong_FromSize_t( stats.nBroadphasePairs ) );
+			setItem( "contacts", PyLong_FromSize_t( stats.nContacts ) );
+			setItem( "collidingContacts", PyLong_FromSize_t( stats.nCollidingContacts ) );
+			setItem( "solverImpulses", PyLong_FromUnsignedLong( stats.nSolverImpulses ) );
+			setItem( "solverIterations", PyLong_FromUnsignedLong( stats.nSolverIterations ) );
+			setItem( "kineticEnergy", PyFloat_FromDouble( (double) stats.fKineticEnergy ) );
+			setItem( "integrateMS", PyFloat_FromDouble( (double) stats.fIntegrateMS ) );
+			setItem( "broadphaseMS", PyFloat_FromDouble( (double) stats.fBroadphaseMS ) );
+			setItem( "narrowphaseMS", PyFloat_FromDouble( (double) stats.fNarrowphaseMS ) );
+			setItem( "solveMS", PyFloat_FromDouble( (double) stats.fSolveMS ) );
+
+			return pDict;
+		}
+		return nullptr;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "NarrowPhase.h"
+#include "CollisionDispatch.h"
+
+using EType = RigidBody2D::EType;
+
+// Run one bucket; the types are known at compile time so every call goes to the same overload
+template <EType eA, EType eB>
+size_t runBucket( const std::vector<SweepAndPrune::Pair>& vPairs, const RigidBody2D * pBodies, std::vector<Contact>& vContacts, const float fDT ) noexcept
+{
+	size_t nCulled( 0 );
+	for ( const SweepAndPrune::Pair& pair : vPairs )
+	{
+		if ( SpecContactDispatch<eA, eB>::Get( &pBodies[pair.uIdxA], &pBodies[pair.uIdxB], vContacts, fDT ) == 0 )
+			nCulled++;
+	}
+
+	return nCulled;
+}
+
+void NarrowPhase::Clear()
+{
+	for ( std::vector<SweepAndPrune::Pair>& vBucket : m_avBuckets )
+		vBucket.clear();
+}
+
+void NarrowPhase::AddPair( const RigidBody2D * pBodies, uint32_t uIdxA, uint32_t uIdxB )
+{
+	if ( pBodies[uIdxA].eType > pBodies[uIdxB].eType )
+		std::swap( uIdxA, uIdxB );
+
+	const int iBucket = 4 * (int) pBodies[uIdxA].eType + (int) pBodies[uIdxB].eType;
+	m_avBuckets[iBucket].push_back( { uIdxA, uIdxB } );
+}
+
+size_t NarrowPhase::GetSpeculativeContacts( const RigidBody2D * pBodies, std::vector<Contact>& vContacts, const float fDT ) noexcept
+{
+	// Pairs are ordered so only the upper triangle is used
+	auto bucket = [this] ( EType eA, EType eB ) -> const std::vector<SweepAndPrune::Pair>&
+	{
+		return m_avBuckets[4 * (int) eA + (int) eB];
+	};
+
+	size_t nCulled( 0 );
+	nCulled += m_CircleBatch.GetSpeculativeContacts( pBodies, bucket( EType::Circle, EType::Circle ), vContacts, fDT );
+	nCulled += runBucket<EType::Circle, EType::AABB>( bucket( EType::Circle, EType::AABB ), pBodies, vContacts, fDT );
+	nCulled += runBucket<EType::Circle, EType::OBB>( bucket( EType::Circle, EType::OBB ), pBodies, vContacts, fDT );
+	nCulled += runBucket<EType::AABB, EType::AABB>( bucket( EType::AABB, EType::AABB ), pBodies, vContacts, fDT );
+	nCulled += runBucket<EType::AABB, EType::OBB>( bucket( EType::AABB, EType::OBB ), pBodies, vContacts, fDT );
+	nCulled += runBucket<EType::OBB, EType::OBB>( bucket( EType::OBB, EType::OBB ), pBodies, vContacts, fDT );
+
+	// Anything involving EType::None can't make contacts
+	for ( int i = 0; i < 4; i++ )
+		nCulled += m_avBuckets[i].size();
+
+	return nCulled;
+}
+
+size_t NarrowPhase::GetNumPairs() const
+{
+	size_t nPairs( 0 );
+	for ( const std::vector<SweepAndPrune::Pair>& vBucket : m_avBuckets )
+		nPairs += vBucket.size();
+	return nPairs;
+}
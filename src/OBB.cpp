@@ -1,9 +1,17 @@
 #include "RigidBody2D.h"
 #include "CollisionFunctions.h"
-#include "GL_Util.h"
+#include "Glm_Util.h"
 #include "Util.h"
 
 #include <glm/gtx/norm.hpp>
+#include <cfloat>
+#include <climits>
+
+// Use SSE2 if the compiler lets us (it's always there on x64)
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define OBB_USE_SSE
+#include <emmintrin.h>
+#endif
 
 // Used to handle collisions between OBBs
 struct FeaturePair
@@ -50,9 +58,8 @@ struct SupportVertex
 // vertices that are most in line with that direction
 int GetSupportVerts( OBB * pOBB, vec2 N, std::array<SupportVertex, 2> * aSV )
 {
-	// Temporarily move the box back to the origin
-	vec2 v2Center = pOBB->v2Center;
-	pOBB->v2Center = vec2();
+	// Measure from the center, so the tolerance below doesn't depend on where the box is
+	const vec2 v2Center = pOBB->GetCenter();
 
 	int ixClosest( -1 ), ixSecondClosest( -1 );
 	float fClosestDist( -FLT_MAX ), fSecondClosestDist( -FLT_MAX );
@@ -61,7 +68,7 @@ int GetSupportVerts( OBB * pOBB, vec2 N, std::array<SupportVertex, 2> * aSV )
 	// most closely aligns with the normal
 	for ( int i = 0; i < 4; i++ )
 	{
-		float fDist = glm::dot( N, GetVert( pOBB, i ) );
+		float fDist = glm::dot( N, GetVert( pOBB, i ) - v2Center );
 		if ( fDist > fClosestDist )
 		{
 			fClosestDist = fDist;
@@ -75,7 +82,7 @@ int GetSupportVerts( OBB * pOBB, vec2 N, std::array<SupportVertex, 2> * aSV )
 		if ( i == ixClosest )
 			continue;
 
-		float fDist = glm::dot( N, GetVert( pOBB, i ) );
+		float fDist = glm::dot( N, GetVert( pOBB, i ) - v2Center );
 		if ( feq( fDist, fClosestDist ) )
 		{
 			fSecondClosestDist = fDist;
@@ -83,9 +90,6 @@ int GetSupportVerts( OBB * pOBB, vec2 N, std::array<SupportVertex, 2> * aSV )
 		}
 	}
 
-	// Reassign center
-	pOBB->v2Center = v2Center;
-
 	// Fill array, return count
 	aSV->at( 0 ) = { GetVert( pOBB, ixClosest ), ixClosest };
 
@@ -114,6 +118,87 @@ std::array<glm::vec2, 2> GetSupportNeighbor( OBB * pOBB, vec2 n, int ixSupportVe
 	return{ vB, vC };
 }
 
+// Weigh one support vertex of pVertex against face ixFace of pFace, and keep it if it beats
+// the best separated or penetrating feature pair found so far. wsN, wsV0 and wsV1 are the
+// face normal and edge, fDist the support vertex's distance along the normal, fCenterDist2 its
+// squared distance from pFace's center and bInside whether it's inside pFace
+void ConsiderFeature( OBB * pFace, OBB * pVertex, const vec2 wsN, const vec2 wsV0, const vec2 wsV1, const int ixFace,
+					  const SupportVertex& sv, const float fDist, const float fCenterDist2, const bool bInside,
+					  FeaturePair * pMostSep, FeaturePair * pMostPen, FeaturePair::EType e )
+{
+	// Form the minkowski face of {wsV0, wsV1} - {sv.v}
+	const vec2 mfp0 = sv.v - wsV0;
+	const vec2 mfp1 = sv.v - wsV1;
+
+	// Compute the squared distance
+	float fDist2 = fDist * fDist;
+
+	// If the projection has a positive value, we are separated
+	if ( fDist > 0 )
+	{
+		// The real distance between the vertex and face is the projection
+		// of the origin onto the minkowski face (like GJK, I think)
+		const vec2 projPoint = projectOnEdge( vec2(), mfp0, mfp1 );
+		fDist2 = glm::length2( projPoint );
+
+		// If this is a better candidate, reassign
+		if ( fDist2 < pMostSep->fDist2 )
+		{
+			*pMostSep = FeaturePair( fDist2, fCenterDist2, sv.idx, ixFace, e );
+		}
+		// If they're very close
+		else if ( feq( fDist2, pMostSep->fDist2 ) && pMostSep->eType == e )
+		{
+			// Pick the vertex closest to the face object's center
+			if ( fCenterDist2 < pMostSep->fCenDist2 )
+			{
+				*pMostSep = FeaturePair( fDist2, fCenterDist2, sv.idx, ixFace, e );
+			}
+			// If theose two are very close as well...
+			else if ( feq( fCenterDist2, pMostSep->fCenDist2 ) )
+			{
+				// Some wishful thinking - if we're this desparate, pick the feature pair
+				// with a normal that is most in line with the distance between the two centers
+				vec2 d = pVertex->GetCenter() - pFace->GetCenter();
+				vec2 oldN = GetNormal( pFace, pMostSep->ixFace );
+
+				// If the distance vector more closely aligns with this face normal, reassign
+				if ( glm::dot( wsN, d ) > glm::dot( oldN, d ) )
+					*pMostSep = FeaturePair( fDist2, fCenterDist2, sv.idx, ixFace, e );
+			}
+		}
+	}
+	// If the projected value was negative, we are penetrating
+	else if ( bInside )
+	{
+		// Negate distance squared, it opposes the normal
+		fDist2 = -fDist2;
+
+		// We want the greatest penetration distance
+		if ( fDist2 > pMostPen->fDist2 )
+		{
+			// reassign mostPenetrating
+			*pMostPen = FeaturePair( fDist2, fCenterDist2, sv.idx, ixFace, e );
+		}
+		// A lot of this ambiguity case logic is copied from above
+		else if ( feq( fDist2, pMostPen->fDist2 ) && pMostPen->eType == e )
+		{
+			if ( fCenterDist2 < pMostPen->fCenDist2 )
+			{
+				*pMostPen = FeaturePair( fDist2, fCenterDist2, sv.idx, ixFace, e );
+			}
+			else if ( feq( fCenterDist2, pMostSep->fCenDist2 ) )
+			{
+				vec2 d = pVertex->GetCenter() - pFace->GetCenter();
+				vec2 oldN = GetNormal( pFace, pMostSep->ixFace );
+
+				if ( glm::dot( wsN, d ) > glm::dot( oldN, d ) )
+					*pMostPen = FeaturePair( fDist2, fCenterDist2, sv.idx, ixFace, e );
+			}
+		}
+	}
+}
+
 // Algorithm used to find feature pairs in OBBs by treating one as the face object and one as the verex object
 // This is the algorithm outlined by Paul Firth at http://www.wildbunny.co.uk/blog/2011/04/20/collision-detection-for-dummies/
 // It's rather expensive and could possibly be done without walking so many vertices and faces, but for now I'd 
@@ -132,118 +217,35 @@ void JudgeFeatures( OBB * pFace, OBB * pVertex, FeaturePair * pMostSep, FeatureP
 		std::array<SupportVertex, 2> aSupportVerts;
 		for ( int j = 0; j < GetSupportVerts( pVertex, -wsN, &aSupportVerts ); j++ )
 		{
-			// Form the minkowski face of {wsV0, wsV1} - {aSupportVerts[j].v}
-			const vec2 mfp0 = aSupportVerts[j].v - wsV0;
-			const vec2 mfp1 = aSupportVerts[j].v - wsV1;
-
 			// The distance of the vertex from the normal is the projection of
 			// the vector from the first edge vertex to the support vertex
 			// along the direction of the face normal
-			float fDist = glm::dot( wsN, mfp0 );
-
-			// Compute the squared distance and squared center distance
-			float fDist2 = fDist * fDist;
-			float fCenterDist2 = glm::distance2( aSupportVerts[j].v, pFace->v2Center );
+			const SupportVertex& sv = aSupportVerts[j];
+			float fDist = glm::dot( wsN, sv.v - wsV0 );
+			float fCenterDist2 = glm::distance2( sv.v, pFace->GetCenter() );
+			bool bInside = fDist > 0 ? false : IsPointInside( sv.v, pFace );
 
-			// If the projection has a positive value, we are separated
-			if ( fDist > 0 )
-			{
-				// The real distance between the vertex and face is the projection
-				// of the origin onto the minkowski face (like GJK, I think)
-				const vec2 projPoint = projectOnEdge( vec2(), mfp0, mfp1 );
-				fDist2 = glm::length2( projPoint );
-
-				// If this is a better candidate, reassign
-				if ( fDist2 < pMostSep->fDist2 )
-				{
-					*pMostSep = FeaturePair( fDist2, fCenterDist2, aSupportVerts[j].idx, i, e );
-				}
-				// If they're very close
-				else if ( feq( fDist2, pMostSep->fDist2 ) && pMostSep->eType == e )
-				{
-					// Pick the vertex closest to the face object's center
-					if ( fCenterDist2 < pMostSep->fCenDist2 )
-					{
-						*pMostSep = FeaturePair( fDist2, fCenterDist2, aSupportVerts[j].idx, i, e );
-					}
-					// If theose two are very close as well...
-					else if ( feq( fCenterDist2, pMostSep->fCenDist2 ) )
-					{
-						// Some wishful thinking - if we're this desparate, pick the feature pair
-						// with a normal that is most in line with the distance between the two centers
-						vec2 d = pVertex->v2Center - pFace->v2Center;
-						vec2 oldN = GetNormal( pFace, pMostSep->ixFace );
-
-						// If the distance vector more closely aligns with this face normal, reassign
-						if ( glm::dot( wsN, d ) > glm::dot( oldN, d ) )
-							*pMostSep = FeaturePair( fDist2, fCenterDist2, aSupportVerts[j].idx, i, e );
-					}
-				}
-			}
-			// If the projected value was negative, we are penetrating
-			else if ( IsPointInside( aSupportVerts[j].v, pFace ) )
-			{
-				// Negate distance squared, it opposes the normal
-				fDist2 = -fDist2;
-
-				// We want the greatest penetration distance
-				if ( fDist2 > pMostPen->fDist2 )
-				{
-					// reassign mostPenetrating
-					*pMostPen = FeaturePair( fDist2, fCenterDist2, aSupportVerts[j].idx, i, e );
-				}
-				// A lot of this ambiguity case logic is copied from above
-				else if ( feq( fDist2, pMostPen->fDist2 ) && pMostPen->eType == e )
-				{
-					if ( fCenterDist2 < pMostPen->fCenDist2 )
-					{
-						*pMostPen = FeaturePair( fDist2, fCenterDist2, aSupportVerts[j].idx, i, e );
-					}
-					else if ( feq( fCenterDist2, pMostSep->fCenDist2 ) )
-					{
-						vec2 d = pVertex->v2Center - pFace->v2Center;
-						vec2 oldN = GetNormal( pFace, pMostSep->ixFace );
-
-						if ( glm::dot( wsN, d ) > glm::dot( oldN, d ) )
-							*pMostPen = FeaturePair( fDist2, fCenterDist2, aSupportVerts[j].idx, i, e );
-					}
-				}
-			}
+			ConsiderFeature( pFace, pVertex, wsN, wsV0, wsV1, i, sv, fDist, fCenterDist2, bInside, pMostSep, pMostPen, e );
 		}
 	}
-
 }
 
-// Functions for getting speculative contacts
-std::list<Contact> GetSpecContacts( OBB * pA, OBB * pB )
+// Pick the best feature pair out of the most separated and most penetrating
+// candidates, returns null if neither is usable (i.e. the boxes are degenerate)
+FeaturePair * PickFeaturePair( FeaturePair * pMostSep, FeaturePair * pMostPen )
 {
-	// We're going to want the closest face-vertex feature pair
-	FeaturePair fpMostSeparated, fpMostPenetrating;
-	fpMostPenetrating.fDist2 = -FLT_MAX;
-	FeaturePair::EType e;
-
-	// Find the feature pair that is the best candidate for collision detection
-	JudgeFeatures( pA, pB, &fpMostSeparated, &fpMostPenetrating, FeaturePair::EType::FaceAVertexB );
-	JudgeFeatures( pB, pA, &fpMostSeparated, &fpMostPenetrating, FeaturePair::EType::FaceBVertexA );
-
-	// Determine who is the face and who is the vertex
-	FeaturePair * pFeaturePair = nullptr;
-	OBB * pFace = nullptr, *pVertex = nullptr;
-	if ( fpMostPenetrating.fDist2 <= 0 && fpMostPenetrating.eType != FeaturePair::EType::None )
-	{
-		pFeaturePair = &fpMostPenetrating;
-	}
-	else if ( fpMostSeparated.fDist2 > 0 && fpMostSeparated.eType != FeaturePair::EType::None )
-	{
-		pFeaturePair = &fpMostSeparated;
-	}
-	else
-	{
-		throw std::runtime_error( "Something went wrong during an OBB-OBB in GetSpecContacts(OBB *, OBB *)!" );
-		return{};
-	}
+	if ( pMostPen->fDist2 <= 0 && pMostPen->eType != FeaturePair::EType::None )
+		return pMostPen;
+	if ( pMostSep->fDist2 > 0 && pMostSep->eType != FeaturePair::EType::None )
+		return pMostSep;
+	return nullptr;
+}
 
+// Build the one or two point manifold for a feature pair and append it to vContacts
+uint32_t EmitFeatureContacts( OBB * pA, OBB * pB, const FeaturePair * pFeaturePair, std::vector<Contact>& vContacts )
+{
 	// All this feels rather clunky...
+	OBB * pFace = nullptr, *pVertex = nullptr;
 	if ( pFeaturePair->eType == FeaturePair::EType::FaceAVertexB )
 	{
 		pFace = pA;
@@ -255,6 +257,10 @@ std::list<Contact> GetSpecContacts( OBB * pA, OBB * pB )
 		pFace = pB;
 	}
 
+	// The features are the face/vertex roles, the face index and the vertex index,
+	// the low two bits are left for which of the contacts below this is
+	const uint32_t uFeatureID = 4 * ( 4 * ( 4 * (uint32_t) pFeaturePair->eType + ( pFeaturePair->ixFace + 4 ) % 4 ) + ( pFeaturePair->ixVert + 4 ) % 4 );
+
 	// Get the face normal and edge on pFace, in world space
 	vec2 faceN = GetNormal( pFace, pFeaturePair->ixFace );
 	vec2 faceEdge0 = GetVert( pFace, pFeaturePair->ixFace );
@@ -278,14 +284,147 @@ std::list<Contact> GetSpecContacts( OBB * pA, OBB * pB )
 	{
 		vec2 ptFace = 0.5f * (ptFace0 + ptFace1);
 		vec2 ptVert = 0.5f * (ptVert0 + ptVert1);
-		return{ Contact( pFace, pVertex, ptFace, ptVert, faceN, glm::dot( faceN, ptVert - ptFace ) ) };
+		vContacts.emplace_back( pFace, pVertex, ptFace, ptVert, faceN, glm::dot( faceN, ptVert - ptFace ), uFeatureID + 2 );
+		return 1;
 	}
 	
 	// Otherwise return both
-	return{ 
-		Contact( pFace, pVertex, ptFace0, ptVert0, faceN, fDist0 ),
-		Contact( pFace, pVertex, ptFace1, ptVert1, faceN, fDist1 ) 
-	};
+	vContacts.emplace_back( pFace, pVertex, ptFace0, ptVert0, faceN, fDist0, uFeatureID );
+	vContacts.emplace_back( pFace, pVertex, ptFace1, ptVert1, faceN, fDist1, uFeatureID + 1 );
+	return 2;
+}
+
+// The original OBB-OBB routine, which walks faces and vertices one at a time
+uint32_t GetSpecContactsFeatureWalk( OBB * pA, OBB * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
+{
+	// Don't bother if these two can't reach each other this step
+	if ( IsOutsideSpeculativeMargin( pA, pB, fDT ) )
+		return 0;
+
+	// We're going to want the closest face-vertex feature pair
+	FeaturePair fpMostSeparated, fpMostPenetrating;
+	fpMostPenetrating.fDist2 = -FLT_MAX;
+
+	// Find the feature pair that is the best candidate for collision detection
+	JudgeFeatures( pA, pB, &fpMostSeparated, &fpMostPenetrating, FeaturePair::EType::FaceAVertexB );
+	JudgeFeatures( pB, pA, &fpMostSeparated, &fpMostPenetrating, FeaturePair::EType::FaceBVertexA );
+
+	// Determine who is the face and who is the vertex (degenerate boxes get nothing)
+	FeaturePair * pFeaturePair = PickFeaturePair( &fpMostSeparated, &fpMostPenetrating );
+	if ( pFeaturePair == nullptr )
+		return 0;
+
+	return EmitFeatureContacts( pA, pB, pFeaturePair, vContacts );
+}
+
+// Separating axis version of JudgeFeatures. Every face normal of pFace is an axis;
+// the distances of all four of pVertex's corners along it (and along the negated
+// normal, used to pick support vertices) are computed at once in SIMD registers,
+// as are the inside-pFace tests and center distances. What's left is choosing
+// among at most two support vertices per face, which is shared with JudgeFeatures
+void JudgeFeaturesSAT( OBB * pFace, OBB * pVertex, FeaturePair * pMostSep, FeaturePair * pMostPen, FeaturePair::EType e )
+{
+	const vec2 * pFaceVerts = pFace->boxData.av2Verts;
+	const vec2 * pFaceNormals = pFace->boxData.av2Normals;
+	const vec2 * pVertVerts = pVertex->boxData.av2Verts;
+
+	// Per axis distances of each corner from the face's edge, and from pVertex's center along -N
+	alignas( 16 ) float aDist[4][4], aSupport[4][4];
+	alignas( 16 ) float aCenterDist2[4];
+	alignas( 16 ) int aInside[4];
+
+#ifdef OBB_USE_SSE
+	// The corners of pVertex, one per lane
+	const __m128 vX = _mm_set_ps( pVertVerts[3].x, pVertVerts[2].x, pVertVerts[1].x, pVertVerts[0].x );
+	const __m128 vY = _mm_set_ps( pVertVerts[3].y, pVertVerts[2].y, pVertVerts[1].y, pVertVerts[0].y );
+
+	// Relative to pVertex's center (for support vertices) and pFace's center (for the rest)
+	const __m128 vRelVX = _mm_sub_ps( vX, _mm_set1_ps( pVertex->GetCenter().x ) );
+	const __m128 vRelVY = _mm_sub_ps( vY, _mm_set1_ps( pVertex->GetCenter().y ) );
+	const __m128 vRelFX = _mm_sub_ps( vX, _mm_set1_ps( pFace->GetCenter().x ) );
+	const __m128 vRelFY = _mm_sub_ps( vY, _mm_set1_ps( pFace->GetCenter().y ) );
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		const __m128 vNX = _mm_set1_ps( pFaceNormals[i].x );
+		const __m128 vNY = _mm_set1_ps( pFaceNormals[i].y );
+		const __m128 vEdgeX = _mm_sub_ps( vX, _mm_set1_ps( pFaceVerts[i].x ) );
+		const __m128 vEdgeY = _mm_sub_ps( vY, _mm_set1_ps( pFaceVerts[i].y ) );
+		_mm_store_ps( aDist[i], _mm_add_ps( _mm_mul_ps( vNX, vEdgeX ), _mm_mul_ps( vNY, vEdgeY ) ) );
+
+		const __m128 vNegNX = _mm_set1_ps( -pFaceNormals[i].x );
+		const __m128 vNegNY = _mm_set1_ps( -pFaceNormals[i].y );
+		_mm_store_ps( aSupport[i], _mm_add_ps( _mm_mul_ps( vNegNX, vRelVX ), _mm_mul_ps( vNegNY, vRelVY ) ) );
+	}
+
+	// Corners in pFace's local space, inside if both coordinates are within the half dim
+	const __m128 vXHatX = _mm_set1_ps( pFaceNormals[0].x ), vXHatY = _mm_set1_ps( pFaceNormals[0].y );
+	const __m128 vLocalX = _mm_add_ps( _mm_mul_ps( vRelFX, vXHatX ), _mm_mul_ps( vRelFY, vXHatY ) );
+	const __m128 vLocalY = _mm_add_ps( _mm_mul_ps( vRelFX, _mm_sub_ps( _mm_setzero_ps(), vXHatY ) ), _mm_mul_ps( vRelFY, vXHatX ) );
+	const __m128 vAbsMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+	const __m128 vInside = _mm_and_ps( _mm_cmplt_ps( _mm_and_ps( vLocalX, vAbsMask ), _mm_set1_ps( pFace->boxData.v2HalfDim.x ) ),
+									   _mm_cmplt_ps( _mm_and_ps( vLocalY, vAbsMask ), _mm_set1_ps( pFace->boxData.v2HalfDim.y ) ) );
+	_mm_store_si128( (__m128i *) aInside, _mm_castps_si128( vInside ) );
+	_mm_store_ps( aCenterDist2, _mm_add_ps( _mm_mul_ps( vRelFX, vRelFX ), _mm_mul_ps( vRelFY, vRelFY ) ) );
+#else
+	for ( int k = 0; k < 4; k++ )
+	{
+		const vec2 v2RelV = pVertVerts[k] - pVertex->GetCenter();
+		const vec2 v2RelF = pVertVerts[k] - pFace->GetCenter();
+		for ( int i = 0; i < 4; i++ )
+		{
+			aDist[i][k] = glm::dot( pFaceNormals[i], pVertVerts[k] - pFaceVerts[i] );
+			aSupport[i][k] = glm::dot( -pFaceNormals[i], v2RelV );
+		}
+
+		const float fLocalX = glm::dot( v2RelF, pFaceNormals[0] );
+		const float fLocalY = glm::dot( v2RelF, perp( pFaceNormals[0] ) );
+		aInside[k] = fabs( fLocalX ) < pFace->boxData.v2HalfDim.x && fabs( fLocalY ) < pFace->boxData.v2HalfDim.y;
+		aCenterDist2[k] = glm::dot( v2RelF, v2RelF );
+	}
+#endif
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		// The support vertex is the corner furthest along -N, plus a runner up if it's very close
+		int ixClosest( 0 ), ixSecondClosest( -1 );
+		for ( int k = 1; k < 4; k++ )
+			if ( aSupport[i][k] > aSupport[i][ixClosest] )
+				ixClosest = k;
+		for ( int k = 0; k < 4; k++ )
+			if ( k != ixClosest && feq( aSupport[i][k], aSupport[i][ixClosest] ) )
+				ixSecondClosest = k;
+
+		const int aSupportIdx[2] = { ixClosest, ixSecondClosest };
+		for ( int j = 0; j < 2 && aSupportIdx[j] >= 0; j++ )
+		{
+			const int k = aSupportIdx[j];
+			const SupportVertex sv = { pVertVerts[k], k };
+			ConsiderFeature( pFace, pVertex, pFaceNormals[i], pFaceVerts[i], pFaceVerts[( i + 1 ) % 4], i,
+							 sv, aDist[i][k], aCenterDist2[k], aInside[k] != 0, pMostSep, pMostPen, e );
+		}
+	}
+}
+
+// Functions for getting speculative contacts
+uint32_t GetSpecContacts( OBB * pA, OBB * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
+{
+	// Don't bother if these two can't reach each other this step
+	if ( IsOutsideSpeculativeMargin( pA, pB, fDT ) )
+		return 0;
+
+	// Find the best face-vertex feature pair, testing each box's faces against the other's corners
+	FeaturePair fpMostSeparated, fpMostPenetrating;
+	fpMostPenetrating.fDist2 = -FLT_MAX;
+	JudgeFeaturesSAT( pA, pB, &fpMostSeparated, &fpMostPenetrating, FeaturePair::EType::FaceAVertexB );
+	JudgeFeaturesSAT( pB, pA, &fpMostSeparated, &fpMostPenetrating, FeaturePair::EType::FaceBVertexA );
+
+	// Degenerate boxes (i.e. NaN positions) produce nothing to collide with
+	FeaturePair * pFeaturePair = PickFeaturePair( &fpMostSeparated, &fpMostPenetrating );
+	if ( pFeaturePair == nullptr )
+		return 0;
+
+	return EmitFeatureContacts( pA, pB, pFeaturePair, vContacts );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -297,16 +436,16 @@ glm::vec2 OBB::WorldSpaceClamp( const glm::vec2 p ) const
 		return Clamp( p );
 
 	// u and v are x and y in the OBB's local space
-	vec2 u( cos( fTheta ), sin( fTheta ) );
-	vec2 v = perp( u );
+	const vec2& u = boxData.av2Normals[0];
+	const vec2& v = boxData.av2Normals[3];
 
 	// Transform the vector from the center into OBB local space, clamp to half dim
-	vec2 d = p - v2Center;
+	vec2 d = p - GetCenter();
 	vec2 localPoint( glm::dot( d, u ), glm::dot( d, v ) );
 	localPoint = glm::clamp( localPoint, -boxData.v2HalfDim, boxData.v2HalfDim );
 
 	// Transform back into world space
-	return v2Center + localPoint.x * u + localPoint.y * v;
+	return GetCenter() + localPoint.x * u + localPoint.y * v;
 }
 
 /*static*/ RigidBody2D OBB::Create( glm::vec2 vel, glm::vec2 c, float mass, float elasticity, glm::vec2 v2R, float th /*= 0.f*/ )
@@ -314,7 +453,9 @@ glm::vec2 OBB::WorldSpaceClamp( const glm::vec2 p ) const
 	RigidBody2D ret = RigidBody2D::Create( vel, c, mass, elasticity );
 	ret.boxData.v2HalfDim = v2R / 2.f;
 	ret.eType = RigidBody2D::EType::OBB;
-	ret.fTheta = th;
+	ret.SetTheta( th );
+	ret.UpdateInverseMass();
+	ret.UpdateBoxGeometry();
 	return ret;
 }
 
@@ -323,6 +464,8 @@ glm::vec2 OBB::WorldSpaceClamp( const glm::vec2 p ) const
 	RigidBody2D ret = RigidBody2D::Create( vel, vec2( x, y ), mass, elasticity );
 	ret.boxData.v2HalfDim = vec2( w, h ) / 2.f;
 	ret.eType = RigidBody2D::EType::OBB;
+	ret.UpdateInverseMass();
+	ret.UpdateBoxGeometry();
 	return ret;
 }
 
@@ -332,7 +475,7 @@ bool IsPointInside( vec2 p, OBB * pOBB )
 	if ( pOBB->eType == RigidBody2D::EType::AABB )
 		return IsPointInside( p, (AABB *) pOBB );
 
-	glm::vec2 d = p - pOBB->v2Center;
+	glm::vec2 d = p - pOBB->GetCenter();
 	glm::vec2 xHat = GetNormal( pOBB, 0 );
 	glm::vec2 yHat = perp( xHat );
 	bool bX = fabs( glm::dot( d, xHat ) ) < pOBB->boxData.v2HalfDim.x;
@@ -366,46 +509,16 @@ bool IsOverlapping( OBB * pA, OBB * pB )
 
 glm::vec2 GetVert( OBB * pOBB, int idx )
 {
-	if ( pOBB->eType == RigidBody2D::EType::AABB )
-		return GetVert( (AABB *) pOBB, idx );
-
-	vec2 v2Rad = pOBB->HalfDim();
-	glm::mat2 M = pOBB->GetRotMat();
-
-	switch ( (idx + 4) % 4 )
-	{
-		case 0:
-			return pOBB->v2Center + M *  v2Rad;
-		case 1:
-			return pOBB->v2Center + M * vec2( v2Rad.x, -v2Rad.y );
-		case 2:
-			return pOBB->v2Center - M * v2Rad;
-		case 3:
-			return pOBB->v2Center + M * vec2( -v2Rad.x, v2Rad.y );
-	}
+	// Cached by UpdateBoxGeometry (for AABBs too)
+	return pOBB->boxData.av2Verts[(idx + 4) % 4];
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 glm::vec2 GetNormal( OBB * pOBB, int idx )
 {
-	if ( pOBB->eType == RigidBody2D::EType::AABB )
-		return GetNormal( (AABB *) pOBB, idx );
-
-	float c = cosf( pOBB->fTheta );
-	float s = sinf( pOBB->fTheta );
-
-	switch ( idx % 4 )
-	{
-		case 0:
-			return glm::vec2( c, s );
-		case 1:
-			return glm::vec2( s, -c );
-		case 2:
-			return glm::vec2( -c, -s );
-		case 3:
-			return glm::vec2( -s, c );
-	}
+	// Cached by UpdateBoxGeometry (for AABBs too)
+	return pOBB->boxData.av2Normals[(idx + 4) % 4];
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,751 @@
+#include "PhysicsWorld.h"
+#include "Glm_Util.h"
+#include "Util.h"
+#include "CollisionFunctions.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <iterator>
+#include <cfloat>
+#include <cmath>
+
+// Below this many contacts the islands are solved on the calling thread
+const size_t kMinParallelContacts = 256;
+
+// Identifies the physics section of a snapshot, bump the version whenever what's saved changes
+const uint32_t kSnapshotMagic = 0x53594850;	// "PHYS"
+const uint32_t kSnapshotVersion = 3;
+
+struct SnapshotHeader
+{
+	uint32_t uMagic;
+	uint32_t uVersion;
+	uint32_t uBodySize;		// sizeof( BodyRecord ) in the build that saved it
+	uint32_t uNumBodies;
+	float fTimeStep;
+};
+
+// How a body is saved. Only what can't be worked out again is kept, with
+// the type and sleep flag as plain integers, so that a damaged snapshot
+// can't put an out of range enum or bool into a body
+struct BodyRecord
+{
+	int32_t iType;			// RigidBody2D::EType
+	int32_t iID;
+	uint32_t uAsleep;		// 0 or 1
+	uint32_t uCategory;
+	uint32_t uMask;
+	float fMass;
+	float fElast;
+	float fTheta;
+	float fOmega;
+	float fSleepTime;
+	glm::vec2 v2Vel;
+	glm::vec2 v2Center;
+	glm::vec2 v2Shape;		// Radius in x for circles, half dimensions for boxes
+};
+
+PhysicsWorld::PhysicsWorld( size_t nThreads /*= 0*/ ) :
+	m_bAllowSleep( true ),
+	m_fTimeStep( kDefaultTimeStep ),
+	m_fInvTimeStep( 1.f / kDefaultTimeStep ),
+	m_uNumCulledContacts( 0 ),
+	m_Stats(),
+	m_ContactSolver( 10 ),
+	m_pThreadPool( new ThreadPool( nThreads ) )
+{
+	m_ContactSolver.SetThreadPool( m_pThreadPool.get() );
+}
+
+void PhysicsWorld::Step()
+{
+	// Interpolation blends from here to wherever the step takes things
+	storePrevTransforms();
+
+	// Milliseconds since tBegin, for the phase timings
+	auto msSince = [] ( decltype(Time::now()) tBegin )
+	{
+		return std::chrono::duration<float, std::milli>( Time::now() - tBegin ).count();
+	};
+
+	// Reset the contact arena (it keeps its storage) and the stats
+	m_vSpeculativeContacts.clear();
+	m_vCollisionEvents.clear();
+	m_uNumCulledContacts = 0;
+	m_Stats = Stats();
+	m_Stats.nSubsteps = 1;
+
+	// Integrate objects in the SoA store, which the bodies read their
+	// state from. Boxes that moved need their corners worked out again
+	auto tPhase = Time::now();
+	m_RigidBodyStore.Integrate( m_fTimeStep );
+	for ( const uint32_t uIdx : m_RigidBodyStore.GetBoxIndices() )
+	{
+		RigidBody2D& rb = m_vRigidBodies[uIdx];
+		if ( rb.fMass > 0 && rb.bAsleep == false )
+			rb.UpdateBoxGeometry();
+	}
+	m_Stats.fIntegrateMS = msSince( tPhase );
+
+	// Get out if there's less than 2
+	if ( m_vRigidBodies.size() < 2 )
+	{
+		updateEnergy();
+		return;
+	}
+
+	// Let the broadphase find pairs whose padded bounds overlap,
+	// and wake up anything an awake body is about to hit
+	tPhase = Time::now();
+	const std::vector<SweepAndPrune::Pair>& vPairs = m_Broadphase.FindPairs( m_vRigidBodies, m_fTimeStep );
+	if ( m_bAllowSleep )
+		wakeTouchedBodies( vPairs );
+	m_Stats.nBroadphasePairs = vPairs.size();
+	m_Stats.fBroadphaseMS = msSince( tPhase );
+
+	// Bucket those pairs by type and get speculative contacts for them
+	tPhase = Time::now();
+	m_NarrowPhase.Clear();
+	for ( const SweepAndPrune::Pair& pair : vPairs )
+	{
+		// Pairs without an awake body don't need solving
+		const RigidBody2D& rbA = m_vRigidBodies[pair.uIdxA];
+		const RigidBody2D& rbB = m_vRigidBodies[pair.uIdxB];
+		if ( ( rbA.fMass < 0 || rbA.bAsleep ) && ( rbB.fMass < 0 || rbB.bAsleep ) )
+			continue;
+
+		m_NarrowPhase.AddPair( m_vRigidBodies.data(), pair.uIdxA, pair.uIdxB );
+	}
+
+	// Pairs that are too far apart don't add anything
+	m_uNumCulledContacts = m_NarrowPhase.GetSpeculativeContacts( m_vRigidBodies.data(), m_vSpeculativeContacts, m_fTimeStep );
+	m_Stats.nContacts = m_vSpeculativeContacts.size();
+	m_Stats.fNarrowphaseMS = msSince( tPhase );
+
+	// Start persistent contacts off with the impulse they had last step
+	tPhase = Time::now();
+	m_ContactCache.WarmStart( m_vSpeculativeContacts, m_vRigidBodies.data(), m_fInvTimeStep );
+
+	// Group contacts into islands that share no dynamic bodies
+	const size_t nIslands = m_ContactIslands.Build( m_vSpeculativeContacts, m_vRigidBodies.data(), m_vRigidBodies.size() );
+
+	// The colored solver uses the pool itself, so let it see every contact at once
+	if ( m_ContactSolver.GetMode() == Contact::Solver::EMode::Colored )
+	{
+		m_Stats.nSolverImpulses = m_ContactSolver.Solve( m_vSpeculativeContacts, &m_Stats.nSolverIterations );
+	}
+	else
+	{
+		// Solve each island on its own, spread across the thread pool
+		// unless there are too few contacts to make it worth waking it up
+		m_vIslandIterations.assign( nIslands, 0 );
+		m_vIslandImpulses.assign( nIslands, 0 );
+		auto solveIsland = [this] ( size_t i )
+		{
+			Contact * pBegin = &m_vSpeculativeContacts[m_ContactIslands.GetIslandBegin( i )];
+			m_vIslandImpulses[i] = m_ContactSolver.Solve( pBegin, m_ContactIslands.GetIslandSize( i ), &m_vIslandIterations[i] );
+		};
+
+		if ( m_vSpeculativeContacts.size() < kMinParallelContacts )
+		{
+			for ( size_t i = 0; i < nIslands; i++ )
+				solveIsland( i );
+		}
+		else
+			m_pThreadPool->ParallelFor( nIslands, solveIsland );
+
+		// The step took as long as its slowest island
+		for ( size_t i = 0; i < nIslands; i++ )
+		{
+			m_Stats.nSolverIterations = std::max( m_Stats.nSolverIterations, m_vIslandIterations[i] );
+			m_Stats.nSolverImpulses += m_vIslandImpulses[i];
+		}
+	}
+
+	// Remember contact impulses for next step
+	m_ContactCache.Store( m_vSpeculativeContacts, m_vRigidBodies.data() );
+	m_Stats.fSolveMS = msSince( tPhase );
+
+	// Note every contact that needed an impulse
+	for ( const Contact& c : m_vSpeculativeContacts )
+	{
+		if ( c.IsColliding() == false )
+			continue;
+
+		CollisionEvent ev;
+		ev.iIdA = c.GetBodyA()->GetID();
+		ev.iIdB = c.GetBodyB()->GetID();
+		ev.fImpulse = c.GetCurImpulse();
+		ev.v2Normal = c.GetNormal();
+		ev.v2Point = 0.5f * ( c.GetPosition( 0 ) + c.GetPosition( 1 ) );
+		m_vCollisionEvents.push_back( ev );
+	}
+	m_Stats.nCollidingContacts = m_vCollisionEvents.size();
+
+	// Let resting islands sleep
+	if ( m_bAllowSleep )
+		updateSleep( m_fTimeStep );
+
+	updateEnergy();
+}
+
+void PhysicsWorld::updateEnergy()
+{
+	m_Stats.fKineticEnergy = 0;
+	for ( const RigidBody2D& rb : m_vRigidBodies )
+		if ( rb.fMass > 0 )
+			m_Stats.fKineticEnergy += rb.GetKineticEnergy();
+}
+
+void PhysicsWorld::storePrevTransforms()
+{
+	m_vPrevCenters.resize( m_vRigidBodies.size() );
+	m_vPrevThetas.resize( m_vRigidBodies.size() );
+	for ( size_t i = 0; i < m_vRigidBodies.size(); i++ )
+	{
+		m_vPrevCenters[i] = m_vRigidBodies[i].GetCenter();
+		m_vPrevThetas[i] = m_vRigidBodies[i].GetTheta();
+	}
+}
+
+void PhysicsWorld::wakeTouchedBodies( const std::vector<SweepAndPrune::Pair>& vPairs )
+{
+	// Keep going over the pairs until nothing else wakes up,
+	// so that hitting a sleeping pile wakes all of it at once
+	bool bWokeAny( true );
+	while ( bWokeAny )
+	{
+		bWokeAny = false;
+		for ( const SweepAndPrune::Pair& pair : vPairs )
+		{
+			// We want one sleeping and one awake dynamic body
+			RigidBody2D& rbA = m_vRigidBodies[pair.uIdxA];
+			RigidBody2D& rbB = m_vRigidBodies[pair.uIdxB];
+			if ( rbA.bAsleep == rbB.bAsleep || rbA.fMass < 0 || rbB.fMass < 0 )
+				continue;
+
+			// Wake the sleeper if they're close enough to make contacts
+			if ( IsOutsideSpeculativeMargin( &rbA, &rbB, m_fTimeStep ) == false )
+			{
+				( rbA.bAsleep ? rbA : rbB ).Wake();
+				bWokeAny = true;
+			}
+		}
+	}
+}
+
+void PhysicsWorld::wakeIsland( const size_t rbIdx )
+{
+	// Sleeping bodies make no contacts, so follow last step's broadphase pairs
+	// out from the body, through sleepers close enough to be touching
+	std::vector<bool> vWoken( m_vRigidBodies.size(), false );
+	m_vRigidBodies[rbIdx].Wake();
+	vWoken[rbIdx] = true;
+
+	const std::vector<SweepAndPrune::Pair>& vPairs = m_Broadphase.GetPairs();
+	bool bWokeAny( true );
+	while ( bWokeAny )
+	{
+		bWokeAny = false;
+		for ( const SweepAndPrune::Pair& pair : vPairs )
+		{
+			// We want one body woken here and one asleep
+			if ( vWoken[pair.uIdxA] == vWoken[pair.uIdxB] )
+				continue;
+
+			const uint32_t uSleeper = vWoken[pair.uIdxA] ? pair.uIdxB : pair.uIdxA;
+			RigidBody2D& rbSleeper = m_vRigidBodies[uSleeper];
+			if ( rbSleeper.bAsleep == false )
+				continue;
+
+			if ( IsOutsideSpeculativeMargin( &m_vRigidBodies[pair.uIdxA], &m_vRigidBodies[pair.uIdxB], m_fTimeStep ) == false )
+			{
+				rbSleeper.Wake();
+				vWoken[uSleeper] = true;
+				bWokeAny = true;
+			}
+		}
+	}
+}
+
+void PhysicsWorld::updateSleep( const float fDT )
+{
+	// Track how long each awake body has been slow, and find
+	// the shortest of those times within each island
+	const float fLinSq = g_fSleepLinearVel * g_fSleepLinearVel;
+	m_vIslandSleepTime.assign( m_ContactIslands.GetNumIslands(), FLT_MAX );
+	for ( size_t i = 0; i < m_vRigidBodies.size(); i++ )
+	{
+		RigidBody2D& rb = m_vRigidBodies[i];
+		if ( rb.fMass < 0 || rb.bAsleep )
+			continue;
+
+		if ( glm::dot( rb.GetVel(), rb.GetVel() ) < fLinSq && fabs( rb.GetOmega() ) < g_fSleepAngularVel )
+			rb.fSleepTime += fDT;
+		else
+			rb.fSleepTime = 0;
+
+		const int iIsland = m_ContactIslands.GetBodyIsland( i );
+		if ( iIsland >= 0 )
+			m_vIslandSleepTime[iIsland] = std::min( m_vIslandSleepTime[iIsland], rb.fSleepTime );
+	}
+
+	// Islands go to sleep together, bodies without contacts go on their own
+	for ( size_t i = 0; i < m_vRigidBodies.size(); i++ )
+	{
+		RigidBody2D& rb = m_vRigidBodies[i];
+		if ( rb.fMass < 0 || rb.bAsleep )
+			continue;
+
+		const int iIsland = m_ContactIslands.GetBodyIsland( i );
+		const float fSleepTime = iIsland < 0 ? rb.fSleepTime : m_vIslandSleepTime[iIsland];
+		if ( fSleepTime >= g_fTimeToSleep )
+			rb.Sleep();
+	}
+}
+
+// Look up a shape detail, false if it wasn't provided
+static bool getDetail( const std::map<std::string, float>& mapDetails, const std::string& strKey, float& fVal )
+{
+	auto it = mapDetails.find( strKey );
+	if ( it == mapDetails.end() )
+		return false;
+	fVal = it->second;
+	return true;
+}
+
+// Look up optional collision layer bits, false if they were given but aren't
+// a whole number that a float holds exactly (so at most the low 24 bits)
+static bool getFilterBits( const std::map<std::string, float>& mapDetails, const std::string& strKey, uint32_t& uBits )
+{
+	float fVal( 0 );
+	if ( getDetail( mapDetails, strKey, fVal ) == false )
+		return true;
+	if ( !( fVal >= 0 && fVal <= 16777215.f ) || fVal != floorf( fVal ) )
+		return false;
+	uBits = (uint32_t) fVal;
+	return true;
+}
+
+int PhysicsWorld::AddRigidBody( RigidBody2D::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails )
+{
+	RigidBody2D rb;
+	bool bHaveDetails( false );
+	switch ( eType )
+	{
+		case RigidBody2D::EType::Circle:
+		{
+			float fRad( 0 );
+			if ( ( bHaveDetails = getDetail( mapDetails, "r", fRad ) ) )
+				rb = Circle::Create( v2Vel, v2Pos, fMass, fElasticity, fRad );
+			break;
+		}
+		case RigidBody2D::EType::AABB:
+		{
+			float w( 0 ), h( 0 );
+			if ( ( bHaveDetails = getDetail( mapDetails, "w", w ) && getDetail( mapDetails, "h", h ) ) )
+				rb = AABB::Create( v2Vel, v2Pos, fMass, fElasticity, glm::vec2( w, h ) / 2.f );
+			break;
+		}
+		case RigidBody2D::EType::OBB:
+		{
+			float w( 0 ), h( 0 ), th( 0 );
+			if ( ( bHaveDetails = getDetail( mapDetails, "w", w ) && getDetail( mapDetails, "h", h ) && getDetail( mapDetails, "th", th ) ) )
+				rb = OBB::Create( v2Vel, v2Pos, fMass, fElasticity, glm::vec2( w, h ), th );
+			break;
+		}
+		default:
+			std::cerr << "Error! Invalid type provided when creating Rigid Body!" << std::endl;
+			return -1;
+	}
+
+	if ( bHaveDetails == false )
+	{
+		std::cerr << "Error! Invalid details provided when creating Rigid Body!" << std::endl;
+		return -1;
+	}
+
+	// Reject anything the step can't handle now, so contact generation doesn't have to check
+	switch ( rb.Validate() )
+	{
+		case RigidBody2D::EStatus::Valid:
+			break;
+		case RigidBody2D::EStatus::NotFinite:
+			std::cerr << "Error! Rigid Body created with a NaN or infinite value!" << std::endl;
+			return -1;
+		case RigidBody2D::EStatus::ZeroMass:
+			std::cerr << "Error! Rigid Body created with zero mass (use a negative mass for static bodies)!" << std::endl;
+			return -1;
+		case RigidBody2D::EStatus::BadShape:
+			std::cerr << "Error! Rigid Body created with a non positive size!" << std::endl;
+			return -1;
+		default:
+			std::cerr << "Error! Invalid type provided when creating Rigid Body!" << std::endl;
+			return -1;
+	}
+
+	if ( getFilterBits( mapDetails, "category", rb.uCategory ) == false || getFilterBits( mapDetails, "mask", rb.uMask ) == false )
+	{
+		std::cerr << "Error! Rigid Body collision category and mask must be whole numbers below 2^24!" << std::endl;
+		return -1;
+	}
+
+	m_vRigidBodies.push_back( rb );
+	m_RigidBodyStore.Add( m_vRigidBodies );
+	return m_vRigidBodies.size() - 1;
+}
+
+const RigidBody2D * PhysicsWorld::GetRigidBody2D( const size_t rbIdx ) const
+{
+	if ( rbIdx < m_vRigidBodies.size() )
+		return &m_vRigidBodies[rbIdx];
+	return nullptr;
+}
+
+size_t PhysicsWorld::GetNumRigidBodies() const
+{
+	return m_vRigidBodies.size();
+}
+
+// This is a dumb function...
+std::list<const Contact *> PhysicsWorld::GetContacts() const
+{
+	std::list<const Contact *> liRet;
+	std::transform( m_vSpeculativeContacts.begin(), m_vSpeculativeContacts.end(), std::back_inserter( liRet ),
+					[] ( const Contact& c )
+	{
+		return &c;
+	} );
+	return liRet;
+}
+
+void PhysicsWorld::Stats::Add( const Stats& step )
+{
+	nSubsteps += step.nSubsteps;
+	nBroadphasePairs += step.nBroadphasePairs;
+	nContacts += step.nContacts;
+	nCollidingContacts += step.nCollidingContacts;
+	nSolverImpulses += step.nSolverImpulses;
+	nSolverIterations = std::max( nSolverIterations, step.nSolverIterations );
+	fKineticEnergy = step.fKineticEnergy;
+	fIntegrateMS += step.fIntegrateMS;
+	fBroadphaseMS += step.fBroadphaseMS;
+	fNarrowphaseMS += step.fNarrowphaseMS;
+	fSolveMS += step.fSolveMS;
+}
+
+const PhysicsWorld::Stats& PhysicsWorld::GetStats() const
+{
+	return m_Stats;
+}
+
+const std::vector<Contact>& PhysicsWorld::GetContactBuffer() const
+{
+	return m_vSpeculativeContacts;
+}
+
+const std::vector<PhysicsWorld::CollisionEvent>& PhysicsWorld::GetCollisionEvents() const
+{
+	return m_vCollisionEvents;
+}
+
+size_t PhysicsWorld::GetNumCandidatePairs() const
+{
+	return m_Broadphase.GetNumCandidatePairs();
+}
+
+size_t PhysicsWorld::GetNumCulledContacts() const
+{
+	return m_uNumCulledContacts;
+}
+
+uint32_t PhysicsWorld::GetSolverIterations() const
+{
+	return m_Stats.nSolverIterations;
+}
+
+size_t PhysicsWorld::GetNumIslands() const
+{
+	return m_ContactIslands.GetNumIslands();
+}
+
+void PhysicsWorld::SetSolverMode( Contact::Solver::EMode eMode )
+{
+	m_ContactSolver.SetMode( eMode );
+}
+
+Contact::Solver::EMode PhysicsWorld::GetSolverMode() const
+{
+	return m_ContactSolver.GetMode();
+}
+
+void PhysicsWorld::SetAllowSleep( bool bAllowSleep )
+{
+	m_bAllowSleep = bAllowSleep;
+	if ( m_bAllowSleep == false )
+		WakeAll();
+}
+
+bool PhysicsWorld::GetAllowSleep() const
+{
+	return m_bAllowSleep;
+}
+
+bool PhysicsWorld::WakeRigidBody( const size_t rbIdx )
+{
+	if ( rbIdx < m_vRigidBodies.size() )
+	{
+		m_vRigidBodies[rbIdx].Wake();
+		return true;
+	}
+	return false;
+}
+
+bool PhysicsWorld::SetCollisionFilter( const size_t rbIdx, const uint32_t uCategory, const uint32_t uMask )
+{
+	if ( rbIdx >= m_vRigidBodies.size() )
+		return false;
+
+	RigidBody2D& rb = m_vRigidBodies[rbIdx];
+	if ( rb.uCategory == uCategory && rb.uMask == uMask )
+		return true;
+
+	// What the body rests on or under may have changed, so
+	// it and everything asleep against it have to move again
+	rb.uCategory = uCategory;
+	rb.uMask = uMask;
+	wakeIsland( rbIdx );
+	return true;
+}
+
+void PhysicsWorld::WakeAll()
+{
+	for ( RigidBody2D& rb : m_vRigidBodies )
+		rb.Wake();
+}
+
+size_t PhysicsWorld::GetNumAwakeBodies() const
+{
+	return std::count_if( m_vRigidBodies.begin(), m_vRigidBodies.end(), [] ( const RigidBody2D& rb )
+	{
+		return rb.fMass > 0 && rb.bAsleep == false;
+	} );
+}
+
+size_t PhysicsWorld::GetNumSleepingBodies() const
+{
+	return std::count_if( m_vRigidBodies.begin(), m_vRigidBodies.end(), [] ( const RigidBody2D& rb )
+	{
+		return rb.bAsleep;
+	} );
+}
+
+bool PhysicsWorld::SetTimeStep( float fDT )
+{
+	if ( std::isfinite( fDT ) == false || fDT <= 0 )
+		return false;
+
+	m_fTimeStep = fDT;
+	m_fInvTimeStep = 1.f / fDT;
+	m_ContactSolver.SetTimeStep( fDT );
+	return true;
+}
+
+float PhysicsWorld::GetTimeStep() const
+{
+	return m_fTimeStep;
+}
+
+float PhysicsWorld::GetInvTimeStep() const
+{
+	return m_fInvTimeStep;
+}
+
+quatvec PhysicsWorld::GetInterpolatedQuatVec( const size_t rbIdx, const float fAlpha ) const
+{
+	if ( rbIdx >= m_vRigidBodies.size() )
+		return quatvec();
+
+	// Bodies added since the last step haven't moved yet
+	const RigidBody2D& rb = m_vRigidBodies[rbIdx];
+	if ( rbIdx >= m_vPrevCenters.size() )
+		return rb.GetQuatVec();
+
+	const vec2 v2Center = glm::mix( m_vPrevCenters[rbIdx], rb.GetCenter(), fAlpha );
+	const float fTheta = glm::mix( m_vPrevThetas[rbIdx], rb.GetTheta(), fAlpha );
+
+	// Same as RigidBody2D::GetQuatVec
+	vec3 pos( v2Center, 0.f );
+	fquat rot( cos( fTheta / 2.f ), vec3( 0.f, 0.f, sin( fTheta / 2.f ) ) );
+	return quatvec( pos, rot );
+}
+
+void PhysicsWorld::SetWarmStartFactor( float fFactor )
+{
+	m_ContactCache.SetWarmStartFactor( fFactor );
+}
+
+float PhysicsWorld::GetWarmStartFactor() const
+{
+	return m_ContactCache.GetWarmStartFactor();
+}
+
+std::shared_ptr<const SpatialQuery> PhysicsWorld::MakeSpatialQuery() const
+{
+	// The broadphase's order is a head start on sorting the copies
+	std::vector<uint32_t> vOrder;
+	m_Broadphase.GetOrderByMinX( vOrder );
+	return std::make_shared<const SpatialQuery>( m_vRigidBodies, vOrder );
+}
+
+static BodyRecord makeBodyRecord( const RigidBody2D& rb )
+{
+	BodyRecord rec;
+	rec.iType = (int32_t) rb.eType;
+	rec.iID = rb.GetID();
+	rec.uAsleep = rb.bAsleep ? 1 : 0;
+	rec.uCategory = rb.uCategory;
+	rec.uMask = rb.uMask;
+	rec.fMass = rb.fMass;
+	rec.fElast = rb.fElast;
+	rec.fTheta = rb.GetTheta();
+	rec.fOmega = rb.GetOmega();
+	rec.fSleepTime = rb.fSleepTime;
+	rec.v2Vel = rb.GetVel();
+	rec.v2Center = rb.GetCenter();
+	rec.v2Shape = rb.eType == RigidBody2D::EType::Circle ? vec2( rb.circData.fRadius, 0 ) : rb.boxData.v2HalfDim;
+	return rec;
+}
+
+// Build a body back up from a record, false if the record is out of range
+// or the body wouldn't pass AddRigidBody
+static bool readBodyRecord( const BodyRecord& rec, RigidBody2D& rb )
+{
+	if ( rec.iType < (int32_t) RigidBody2D::EType::Circle || rec.iType > (int32_t) RigidBody2D::EType::OBB )
+		return false;
+	if ( rec.uAsleep > 1 || std::isfinite( rec.fSleepTime ) == false )
+		return false;
+
+	// Sleeping bodies are stopped, integration counts on it
+	if ( rec.uAsleep == 1 && ( rec.v2Vel.x != 0 || rec.v2Vel.y != 0 || rec.fOmega != 0 ) )
+		return false;
+
+	rb = RigidBody2D();
+	rb.eType = (RigidBody2D::EType) rec.iType;
+	rb.SetID( rec.iID );
+	rb.bAsleep = rec.uAsleep == 1;
+	rb.uCategory = rec.uCategory;
+	rb.uMask = rec.uMask;
+	rb.fMass = rec.fMass;
+	rb.fElast = rec.fElast;
+	rb.SetTheta( rec.fTheta );
+	rb.SetOmega( rec.fOmega );
+	rb.fSleepTime = rec.fSleepTime;
+	rb.SetVel( rec.v2Vel );
+	rb.SetCenter( rec.v2Center );
+	if ( rb.eType == RigidBody2D::EType::Circle )
+		rb.circData.fRadius = rec.v2Shape.x;
+	else
+		rb.boxData.v2HalfDim = rec.v2Shape;
+
+	if ( rb.Validate() != RigidBody2D::EStatus::Valid )
+		return false;
+
+	// The cached values come from the rest of the state
+	rb.UpdateInverseMass();
+	rb.UpdateBoxGeometry();
+	return true;
+}
+
+void PhysicsWorld::SaveSnapshot( SnapshotWriter& writer ) const
+{
+	SnapshotHeader header;
+	header.uMagic = kSnapshotMagic;
+	header.uVersion = kSnapshotVersion;
+	header.uBodySize = sizeof( BodyRecord );
+	header.uNumBodies = (uint32_t) m_vRigidBodies.size();
+	header.fTimeStep = m_fTimeStep;
+
+	std::vector<BodyRecord> vRecords;
+	vRecords.reserve( m_vRigidBodies.size() );
+	for ( const RigidBody2D& rb : m_vRigidBodies )
+		vRecords.push_back( makeBodyRecord( rb ) );
+
+	writer.Write( header );
+	writer.Write( vRecords.data(), vRecords.size() );
+	m_ContactCache.SaveSnapshot( writer );
+}
+
+bool PhysicsWorld::ReadSnapshot( SnapshotReader& reader, SnapshotState& state ) const
+{
+	SnapshotHeader header;
+	if ( reader.Read( header ) == false || header.uMagic != kSnapshotMagic )
+	{
+		std::cerr << "Error! Snapshot has no physics section" << std::endl;
+		return false;
+	}
+
+	if ( header.uVersion != kSnapshotVersion || header.uBodySize != sizeof( BodyRecord ) )
+	{
+		std::cerr << "Error! Snapshot is version " << header.uVersion << " with " << header.uBodySize << " byte bodies, expected version "
+			<< kSnapshotVersion << " with " << sizeof( BodyRecord ) << std::endl;
+		return false;
+	}
+
+	if ( header.uNumBodies > reader.GetRemaining() / sizeof( BodyRecord ) || !( header.fTimeStep > 0 ) || std::isfinite( header.fTimeStep ) == false )
+	{
+		std::cerr << "Error! Snapshot physics section is damaged" << std::endl;
+		return false;
+	}
+
+	std::vector<BodyRecord> vRecords( header.uNumBodies );
+	reader.Read( vRecords.data(), vRecords.size() );
+	state.vRigidBodies.resize( vRecords.size() );
+	for ( size_t i = 0; i < vRecords.size(); i++ )
+	{
+		if ( readBodyRecord( vRecords[i], state.vRigidBodies[i] ) == false )
+		{
+			std::cerr << "Error! Snapshot holds an invalid Rigid Body" << std::endl;
+			return false;
+		}
+	}
+
+	if ( state.contactCache.LoadSnapshot( reader ) == false )
+	{
+		std::cerr << "Error! Snapshot contact cache is damaged" << std::endl;
+		return false;
+	}
+
+	state.fTimeStep = header.fTimeStep;
+	return true;
+}
+
+void PhysicsWorld::ApplySnapshot( SnapshotState& state )
+{
+	// The old bodies are views of the store, which is about to change under them
+	m_vRigidBodies.swap( state.vRigidBodies );
+	state.vRigidBodies.clear();
+	m_RigidBodyStore.Bind( m_vRigidBodies );
+	state.contactCache.SetWarmStartFactor( m_ContactCache.GetWarmStartFactor() );
+	std::swap( m_ContactCache, state.contactCache );
+	SetTimeStep( state.fTimeStep );
+
+	// The last step's contacts point at the old bodies, and nothing
+	// should be interpolated from where the old bodies were
+	m_vSpeculativeContacts.clear();
+	m_vCollisionEvents.clear();
+	m_Broadphase.Clear();
+	m_uNumCulledContacts = 0;
+	m_Stats = Stats();
+	storePrevTransforms();
+}
+
+bool PhysicsWorld::LoadSnapshot( SnapshotReader& reader )
+{
+	SnapshotState state;
+	if ( ReadSnapshot( reader, state ) == false )
+		return false;
+
+	ApplySnapshot( state );
+	return true;
+}
@@ -1,22 +1,26 @@
 #include "RigidBody2D.h"
-#include "GL_Util.h"
+#include "Glm_Util.h"
 #include "Util.h"
 #include "CollisionFunctions.h"
+#include "CollisionDispatch.h"
 
 #include <glm/gtx/norm.hpp>
+#include <cmath>
 
 // Euler integrate rigid body translation/rotation
 void RigidBody2D::EulerAdvance( float fDT )
 {
-	// Skip anything with a negative mass
-	if ( fMass < 0 )
+	// Skip anything with a negative mass, or that's sleeping
+	if ( fMass < 0 || bAsleep )
 		return;
 
 	// You should try Verlet...
-	v2Center += fDT * v2Vel;
+	SetCenter( GetCenter() + fDT * GetVel() );
 
 	if ( eType == EType::OBB )
-		fTheta += fDT * fOmega;
+		SetTheta( GetTheta() + fDT * GetOmega() );
+
+	UpdateBoxGeometry();
 
 	//v2Vel.y -= 28.f * fDT;
 }
@@ -24,22 +28,85 @@ void RigidBody2D::EulerAdvance( float fDT )
 RigidBody2D::RigidBody2D() :
 	eType( EType::None ),
 	fMass( 0 ),
+	fInvMass( 0 ),
+	fInvInertia( 0 ),
 	fElast( 0 ),
-	fTheta( 0 ),
-	fOmega( 0 ),
-	v2Vel( 0 ),
-	v2Center( 0 )
+	bAsleep( false ),
+	fSleepTime( 0 ),
+	uCategory( 1 ),
+	uMask( ~0u ),
+	m_State( vec2( 0 ), vec2( 0 ), 0 )
 {}
 
 RigidBody2D::RigidBody2D( glm::vec2 vel, glm::vec2 c, float mass, float elasticity, float th /*= 0.f*/ ) :
 	eType( EType::None ),
 	fMass( mass ),
+	fInvMass( 0 ),
+	fInvInertia( 0 ),
 	fElast( elasticity ),
-	fTheta( th ),
-	fOmega( 0 ),
+	bAsleep( false ),
+	fSleepTime( 0 ),
+	uCategory( 1 ),
+	uMask( ~0u ),
+	m_State( c, vel, th )
+{
+}
+
+RigidBody2D::State::State( const vec2 c, const vec2 vel, const float th ) :
+	v2Center( c ),
 	v2Vel( vel ),
-	v2Center( c )
+	fTheta( th ),
+	fOmega( 0 )
+{
+	pointAtSelf();
+}
+
+RigidBody2D::State::State( const State& other ) :
+	v2Center( *other.pCenter ),
+	v2Vel( *other.pVel ),
+	fTheta( *other.pTheta ),
+	fOmega( *other.pOmega )
+{
+	pointAtSelf();
+}
+
+RigidBody2D::State& RigidBody2D::State::operator=( const State& other )
+{
+	// Read through other's pointers before ours move, other may be this
+	const vec2 c = *other.pCenter, vel = *other.pVel;
+	const float th = *other.pTheta, om = *other.pOmega;
+	v2Center = c;
+	v2Vel = vel;
+	fTheta = th;
+	fOmega = om;
+	pointAtSelf();
+	return *this;
+}
+
+void RigidBody2D::State::pointAtSelf()
 {
+	pCenter = &v2Center;
+	pVel = &v2Vel;
+	pTheta = &fTheta;
+	pOmega = &fOmega;
+}
+
+void RigidBody2D::Sleep()
+{
+	SetVel( vec2( 0 ) );
+	SetOmega( 0 );
+	bAsleep = true;
+}
+
+void RigidBody2D::Wake()
+{
+	bAsleep = false;
+	fSleepTime = 0;
+}
+
+/*static*/ bool RigidBody2D::ShouldCollide( const RigidBody2D& rbA, const RigidBody2D& rbB ) noexcept
+{
+	return ( rbA.uCategory & rbB.uMask ) && ( rbB.uCategory & rbA.uMask );
 }
 
 /*static*/ RigidBody2D RigidBody2D::Create( glm::vec2 vel, glm::vec2 c, float mass, float elasticity, float th /*= 0.f*/ )
@@ -49,102 +116,196 @@ RigidBody2D::RigidBody2D( glm::vec2 vel, glm::vec2 c, float mass, float elastici
 
 vec2 RigidBody2D::GetMomentum() const
 {
-	return fMass * v2Vel;
+	return fMass * GetVel();
 }
 
 float RigidBody2D::GetKineticEnergy() const
 {
-	float fKeTr = 0.5f * fMass * glm::dot( v2Vel, v2Vel );
-	float fKeRot = 0.5f * GetInertia() * powf( fOmega, 2 );
+	float fKeTr = 0.5f * fMass * glm::dot( GetVel(), GetVel() );
+	float fKeRot = 0.5f * GetInertia() * powf( GetOmega(), 2 );
 	return fKeTr + fKeRot;
 }
 
 // Return the graphical quatvec transform of a rigid body
 quatvec RigidBody2D::GetQuatVec() const
 {
-	vec3 pos( v2Center, 0.f );
-	fquat rot( cos( fTheta / 2.f ), vec3( 0.f, 0.f, sin( fTheta / 2.f ) ) );
+	vec3 pos( GetCenter(), 0.f );
+	fquat rot( cos( GetTheta() / 2.f ), vec3( 0.f, 0.f, sin( GetTheta() / 2.f ) ) );
 	return quatvec( pos, rot );
 }
 
 // Construct rotation matrix
 glm::mat2 RigidBody2D::GetRotMat() const
 {
-	float c = cos( fTheta );
-	float s = sin( fTheta ); 
+	float c = cos( GetTheta() );
+	float s = sin( GetTheta() ); 
 	// glm wants transpose
 	return glm::mat2( vec2( c, s ), vec2( -s, c ) );
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
-/*static*/ std::list<Contact> RigidBody2D::GetSpeculativeContacts( const RigidBody2D * pA, const RigidBody2D * pB )
+/*static*/ uint32_t RigidBody2D::GetSpeculativeContacts( const RigidBody2D * pA, const RigidBody2D * pB, std::vector<Contact>& vContacts, const float fDT ) noexcept
+{
+	// The table takes care of casting and argument order
+	return GetSpecContactFn( pA->eType, pB->eType )( pA, pB, vContacts, fDT );
+}
+
+float RigidBody2D::GetInertia() const noexcept
 {
-	switch ( pA->eType )
+	switch ( eType )
 	{
-		case EType::Circle: 
-		{
-			Circle * pCircA = (Circle *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return GetSpecContacts( pCircA, (Circle *) pB );
-				case EType::AABB:
-					return GetSpecContacts( pCircA, (AABB *) pB );
-				case EType::OBB:
-					return GetSpecContacts( pCircA, (OBB *) pB );
-			}
+		case RigidBody2D::EType::Circle:
+			return 0.5f * fMass * circData.fRadius * circData.fRadius;
+		case RigidBody2D::EType::AABB:
+		case RigidBody2D::EType::OBB:
+			return (fMass / 3.f) * glm::dot( boxData.v2HalfDim, boxData.v2HalfDim );
+	}
+
+	// Invalid bodies never make it into a scene (see Validate)
+	return 0.f;
+}
+
+void RigidBody2D::UpdateInverseMass()
+{
+	// Static bodies (negative mass) get zero, so impulses don't move them
+	if ( fMass > 0 )
+	{
+		fInvMass = 1.f / fMass;
+		fInvInertia = 1.f / GetInertia();
+	}
+	else
+	{
+		fInvMass = 0.f;
+		fInvInertia = 0.f;
+	}
+}
+
+void RigidBody2D::UpdateBoxGeometry()
+{
+	if ( eType != EType::AABB && eType != EType::OBB )
+		return;
+
+	// AABBs never turn, so they get the identity
+	const float c = eType == EType::OBB ? cosf( GetTheta() ) : 1.f;
+	const float s = eType == EType::OBB ? sinf( GetTheta() ) : 0.f;
+	boxData.m2Rot = glm::mat2( vec2( c, s ), vec2( -s, c ) );
+
+	// See CollisionFunctions.h for the numbering
+	const vec2& R = boxData.v2HalfDim;
+	const vec2& v2Center = GetCenter();
+	boxData.av2Verts[0] = v2Center + boxData.m2Rot * R;
+	boxData.av2Verts[1] = v2Center + boxData.m2Rot * vec2( R.x, -R.y );
+	boxData.av2Verts[2] = v2Center - boxData.m2Rot * R;
+	boxData.av2Verts[3] = v2Center + boxData.m2Rot * vec2( -R.x, R.y );
+
+	boxData.av2Normals[0] = vec2( c, s );
+	boxData.av2Normals[1] = vec2( s, -c );
+	boxData.av2Normals[2] = vec2( -c, -s );
+	boxData.av2Normals[3] = vec2( -s, c );
+}
+
+RigidBody2D::EStatus RigidBody2D::Validate() const noexcept
+{
+	// The rest depends on the type being real
+	float fSize( 0 );
+	switch ( eType )
+	{
+		case RigidBody2D::EType::Circle:
+			fSize = circData.fRadius;
 			break;
-		}
-		case EType::AABB:
-		{
-			AABB * pBoxA = (AABB *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return GetSpecContacts( (Circle *) pB, pBoxA );
-				case EType::AABB:
-					return GetSpecContacts( pBoxA, (AABB *) pB );
-				case EType::OBB:
-					return GetSpecContacts( pBoxA, (OBB *) pB );
-			}
+		case RigidBody2D::EType::AABB:
+		case RigidBody2D::EType::OBB:
+			fSize = std::min( boxData.v2HalfDim.x, boxData.v2HalfDim.y );
 			break;
-		}
-		case EType::OBB:
+		default:
+			return EStatus::BadType;
+	}
+
+	const float afState[] = { fMass, fInvMass, fInvInertia, fElast, GetTheta(), GetOmega(), GetVel().x, GetVel().y, GetCenter().x, GetCenter().y, fSize };
+	for ( float f : afState )
+		if ( std::isfinite( f ) == false )
+			return EStatus::NotFinite;
+
+	if ( fMass == 0 )
+		return EStatus::ZeroMass;
+
+	if ( fSize <= 0 )
+		return EStatus::BadShape;
+
+	return EStatus::Valid;
+}
+
+// Half extents of the world space box that bounds this body
+glm::vec2 RigidBody2D::GetBoundingHalfDim() const noexcept
+{
+	switch ( eType )
+	{
+		case RigidBody2D::EType::Circle:
+			return vec2( circData.fRadius );
+		case RigidBody2D::EType::AABB:
+			return boxData.v2HalfDim;
+		case RigidBody2D::EType::OBB:
 		{
-			OBB * pBoxA = (OBB *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return GetSpecContacts( (Circle *) pB, pBoxA );
-				case EType::AABB:
-					return GetSpecContacts( (AABB *) pB, pBoxA );
-				case EType::OBB:
-					return GetSpecContacts( (OBB *) pA, (OBB *) pB );
-			}
-			break;
+			// Project the rotated half dim onto x and y
+			float c = fabs( boxData.av2Normals[0].x );
+			float s = fabs( boxData.av2Normals[0].y );
+			const vec2& R = boxData.v2HalfDim;
+			return vec2( c * R.x + s * R.y, s * R.x + c * R.y );
 		}
 	}
 
-	throw std::runtime_error( "Error: Invalid rigid body type!" );
-	return{};
+	return vec2( 0 );
 }
 
-float RigidBody2D::GetInertia() const
+// Radius of the circle around the center that bounds this body
+float RigidBody2D::GetBoundingRadius() const noexcept
 {
 	switch ( eType )
 	{
 		case RigidBody2D::EType::Circle:
-			return 0.5f * fMass * pow( circData.fRadius, 2 );
+			return circData.fRadius;
 		case RigidBody2D::EType::AABB:
 		case RigidBody2D::EType::OBB:
-			return (fMass / 3.f) * (pow( boxData.v2HalfDim.x, 2 ) + pow( boxData.v2HalfDim.y, 2 ));
+			return glm::length( boxData.v2HalfDim );
 	}
 
-	throw std::runtime_error( "Error: Inertia queried for invalid rigid body" );
 	return 0.f;
 }
 
+// Determine whether two bodies are too far apart to come into
+// contact this step. Nothing can close the gap between their bounding
+// circles faster than their relative speed plus the speed at which
+// their extremities swing around, so if that isn't enough to cover
+// the gap in one step (with some slack) there's no need for a contact
+bool IsOutsideSpeculativeMargin( const RigidBody2D * pA, const RigidBody2D * pB, const float fDT ) noexcept
+{
+	const float fRadA = pA->GetBoundingRadius();
+	const float fRadB = pB->GetBoundingRadius();
+
+	// The gap between the bounding circles
+	const float fGap = glm::length( pB->GetCenter() - pA->GetCenter() ) - fRadA - fRadB;
+	if ( fGap <= 0 )
+		return false;
+
+	// Static bodies don't move
+	float fMaxSpeed( 0.f );
+	vec2 v2RelVel( 0 );
+	if ( pA->fMass > 0 )
+	{
+		v2RelVel -= pA->GetVel();
+		fMaxSpeed += fabs( pA->GetOmega() ) * fRadA;
+	}
+	if ( pB->fMass > 0 )
+	{
+		v2RelVel += pB->GetVel();
+		fMaxSpeed += fabs( pB->GetOmega() ) * fRadB;
+	}
+	fMaxSpeed += glm::length( v2RelVel );
+
+	return fGap > fMaxSpeed * fDT + g_fSpeculativeMargin;
+}
+
 // I need a good file for these
 vec2 perp( vec2 v )
 {
@@ -0,0 +1,164 @@
+#include "RigidBodyStore.h"
+#include "Glm_Util.h"
+
+// Use SSE if the compiler lets us (it's always there on x64)
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define RBSTORE_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+// Arrays are padded to a multiple of this so the kernel needs no remainder loop
+const size_t kSimdWidth = 4;
+
+RigidBodyStore::RigidBodyStore() :
+	m_uCount( 0 )
+{}
+
+void RigidBodyStore::Add( std::vector<RigidBody2D>& vRigidBodies )
+{
+	// Where the first body's state is, if nothing has moved
+	const glm::vec2 * pFirst = m_uCount > 0 ? m_vCenter.data() : nullptr;
+
+	const size_t idx = m_uCount;
+	resize( idx + 1 );
+	store( vRigidBodies.back(), idx );
+
+	// If the body vector grew its bodies are copies holding their own state, and if
+	// these arrays grew the bodies point at the old ones; either way the state in
+	// here is still right, the bodies just have to be pointed at it again
+	if ( idx > 0 && ( m_vCenter.data() != pFirst || vRigidBodies.front().m_State.pCenter != pFirst ) )
+		for ( size_t i = 0; i < idx; i++ )
+			bind( vRigidBodies[i], i );
+}
+
+void RigidBodyStore::Bind( std::vector<RigidBody2D>& vRigidBodies )
+{
+	// Any of them could be pointing in here already, so they
+	// all take their own copy before the arrays change
+	for ( RigidBody2D& rb : vRigidBodies )
+		rb.m_State = RigidBody2D::State( rb.m_State );
+
+	m_uCount = 0;
+	m_vBoxIndices.clear();
+	resize( vRigidBodies.size() );
+	for ( size_t i = 0; i < vRigidBodies.size(); i++ )
+		store( vRigidBodies[i], i );
+}
+
+void RigidBodyStore::resize( const size_t uCount )
+{
+	m_uCount = uCount;
+	const size_t uPadded = kSimdWidth * ( ( m_uCount + kSimdWidth - 1 ) / kSimdWidth );
+	m_vCenter.resize( uPadded, vec2( 0 ) );
+	m_vVel.resize( uPadded, vec2( 0 ) );
+	for ( std::vector<float> * pArr : { &m_vTheta, &m_vOmega, &m_vInvMass, &m_vInvInertia, &m_vRotates } )
+		pArr->resize( uPadded, 0.f );
+}
+
+void RigidBodyStore::store( RigidBody2D& rb, const size_t idx )
+{
+	m_vCenter[idx] = rb.GetCenter();
+	m_vVel[idx] = rb.GetVel();
+	m_vTheta[idx] = rb.GetTheta();
+	m_vOmega[idx] = rb.GetOmega();
+	m_vInvMass[idx] = rb.fInvMass;
+	m_vInvInertia[idx] = rb.fInvInertia;
+
+	// Right now OBB is the only primitive whose angle is integrated
+	m_vRotates[idx] = rb.eType == RigidBody2D::EType::OBB ? 1.f : 0.f;
+	if ( rb.eType == RigidBody2D::EType::AABB || rb.eType == RigidBody2D::EType::OBB )
+		m_vBoxIndices.push_back( (uint32_t) idx );
+
+	bind( rb, idx );
+}
+
+void RigidBodyStore::bind( RigidBody2D& rb, const size_t idx )
+{
+	rb.m_State.pCenter = &m_vCenter[idx];
+	rb.m_State.pVel = &m_vVel[idx];
+	rb.m_State.pTheta = &m_vTheta[idx];
+	rb.m_State.pOmega = &m_vOmega[idx];
+}
+
+void RigidBodyStore::Integrate( const float fDT )
+{
+#ifdef RBSTORE_USE_SSE
+	const __m128 vDT = _mm_set1_ps( fDT );
+	const __m128 vZero = _mm_setzero_ps();
+
+	// Centers and velocities are x, y pairs, so four bodies take two registers of them
+	static_assert( sizeof( glm::vec2 ) == 2 * sizeof( float ), "glm::vec2 must be two packed floats" );
+	float * pCenter = &m_vCenter[0].x;
+	const float * pVel = &m_vVel[0].x;
+
+	for ( size_t i = 0; i < m_vTheta.size(); i += kSimdWidth )
+	{
+		// Static bodies have zero inverse mass, build a mask of everything else
+		const __m128 vDynamic = _mm_cmpgt_ps( _mm_loadu_ps( &m_vInvMass[i] ), vZero );
+		const __m128 vRotates = _mm_and_ps( vDynamic, _mm_cmpgt_ps( _mm_loadu_ps( &m_vRotates[i] ), vZero ) );
+
+		// Spread the mask out so each body's lane covers its x and y
+		const __m128 vDynamicLo = _mm_unpacklo_ps( vDynamic, vDynamic );
+		const __m128 vDynamicHi = _mm_unpackhi_ps( vDynamic, vDynamic );
+
+		// Masked steps are zero, so static bodies stay put
+		float * pC = pCenter + 2 * i;
+		const float * pV = pVel + 2 * i;
+		const __m128 vStepLo = _mm_and_ps( vDynamicLo, _mm_mul_ps( vDT, _mm_loadu_ps( pV ) ) );
+		const __m128 vStepHi = _mm_and_ps( vDynamicHi, _mm_mul_ps( vDT, _mm_loadu_ps( pV + kSimdWidth ) ) );
+		const __m128 vStepTh = _mm_and_ps( vRotates, _mm_mul_ps( vDT, _mm_loadu_ps( &m_vOmega[i] ) ) );
+
+		_mm_storeu_ps( pC, _mm_add_ps( _mm_loadu_ps( pC ), vStepLo ) );
+		_mm_storeu_ps( pC + kSimdWidth, _mm_add_ps( _mm_loadu_ps( pC + kSimdWidth ), vStepHi ) );
+		_mm_storeu_ps( &m_vTheta[i], _mm_add_ps( _mm_loadu_ps( &m_vTheta[i] ), vStepTh ) );
+	}
+#else
+	// Same thing, one at a time (masks are 0 or 1 multipliers)
+	for ( size_t i = 0; i < m_vTheta.size(); i++ )
+	{
+		const float fDynamic = m_vInvMass[i] > 0 ? 1.f : 0.f;
+		m_vCenter[i] += fDynamic * fDT * m_vVel[i];
+		m_vTheta[i] += fDynamic * m_vRotates[i] * fDT * m_vOmega[i];
+	}
+#endif
+}
+
+size_t RigidBodyStore::GetCount() const
+{
+	return m_uCount;
+}
+
+const std::vector<uint32_t>& RigidBodyStore::GetBoxIndices() const
+{
+	return m_vBoxIndices;
+}
+
+glm::vec2 RigidBodyStore::GetPosition( const size_t idx ) const
+{
+	return m_vCenter[idx];
+}
+
+glm::vec2 RigidBodyStore::GetVelocity( const size_t idx ) const
+{
+	return m_vVel[idx];
+}
+
+float RigidBodyStore::GetTheta( const size_t idx ) const
+{
+	return m_vTheta[idx];
+}
+
+float RigidBodyStore::GetOmega( const size_t idx ) const
+{
+	return m_vOmega[idx];
+}
+
+float RigidBodyStore::GetInvMass( const size_t idx ) const
+{
+	return m_vInvMass[idx];
+}
+
+float RigidBodyStore::GetInvInertia( const size_t idx ) const
+{
+	return m_vInvInertia[idx];
+}
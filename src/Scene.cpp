@@ -1,9 +1,17 @@
 #include "Scene.h"
 #include "Util.h"
-#include "CollisionFunctions.h"
 
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/random.hpp>
 #include <algorithm>
+#include <iterator>
+
+// Default cap on the steps one Update can run
+const uint32_t kDefaultMaxSubsteps = 16;
+
+// Collision counts are kept in a vector indexed by ID, so
+// IDs at or above this aren't counted rather than grow it
+const int kMaxCountedID = 1 << 16;
 
 Scene::Scene() :
 	m_bQuitFlag( false ),
@@ -11,8 +19,12 @@ Scene::Scene() :
 	m_bPauseCollision( false ),
 	m_GLContext( nullptr ),
 	m_pWindow( nullptr ),
-	m_ContactSolver( 10 )
-{}
+	m_bClockStarted( false ),
+	m_fAccumulator( 0 ),
+	m_uMaxSubsteps( kDefaultMaxSubsteps ),
+	m_uNumSubsteps( 0 )
+{
+}
 
 Scene::~Scene()
 {
@@ -28,6 +40,22 @@ Scene::~Scene()
 	}
 }
 
+// Put a pair of drawables at a contact's points, for debugging
+static void initContactDrawables( const Contact& c, std::array<Drawable *, 2> drPtrArr )
+{
+	const float drScale = 0.2f;
+	vec4 v4Color = glm::linearRand( vec4( vec3( 0.3 ), 1 ), vec4( 1 ) );
+	for ( int i = 0; i < 2; i++ )
+	{
+		if ( drPtrArr[i] )
+		{
+			quatvec qv; 
+			qv.vec = vec3( c.GetPosition( i ), 1.f );
+			drPtrArr[i]->Init( "../models/quad.iqm", v4Color, qv, vec2( drScale ) );
+		}
+	}
+}
+
 void Scene::Draw()
 {
 	// Clear the screen
@@ -55,10 +83,10 @@ void Scene::Draw()
 	{
 		Drawable d1, d2;
 		std::array<Drawable *, 2> pContactDr = { &d1, &d2 };
-		for ( Contact& c : m_liSpeculativeContacts )
+		for ( const Contact& c : m_PhysicsWorld.GetContactBuffer() )
 		{
 			// NYI
-			c.InitDrawable( pContactDr );
+			initContactDrawables( c, pContactDr );
 			for ( Drawable * pDr : pContactDr )
 			{
 				mat4 PMV = P * pDr->GetMV();
@@ -79,46 +107,123 @@ void Scene::Update()
 	// Update the sound manager (should this happen here?)
 	m_SoundManager.Update();
 
-	// If we haven't paused the RB simulation)
-	if ( m_bPauseCollision == false )
+	// See how much time has gone by (nothing on the first call)
+	const auto tNow = Time::now();
+	const float fElapsed = m_bClockStarted ? std::chrono::duration<float>( tNow - m_tLastUpdate ).count() : 0.f;
+	m_tLastUpdate = tNow;
+	m_bClockStarted = true;
+	m_uNumSubsteps = 0;
+	m_vCollisionEvents.clear();
+
+	// Frame stats start from nothing, but the energy is still what it was
+	const float fKineticEnergy = m_FrameStats.fKineticEnergy;
+	m_FrameStats = PhysicsWorld::Stats();
+	m_FrameStats.fKineticEnergy = fKineticEnergy;
+
+	// Time doesn't pile up while the simulation is paused
+	if ( m_bPauseCollision )
+		m_fAccumulator = 0;
+	else
 	{
-		// Reset the contact list and find contacts
-		int nCollisions( 0 );
-		float fTotalEnergy( 0.f );
-		m_liSpeculativeContacts.clear();
+		// Take as many steps as fit in the time we've got
+		const float fTimeStep = m_PhysicsWorld.GetTimeStep();
+		m_fAccumulator += fElapsed;
+		while ( m_fAccumulator >= fTimeStep && m_uNumSubsteps < m_uMaxSubsteps )
+		{
+			Step();
+			m_fAccumulator -= fTimeStep;
+			m_uNumSubsteps++;
+		}
 
-		// Integrate objects
-		for ( RigidBody2D& rb : m_vRigidBodies )
-			rb.EulerAdvance( g_fTimeStep );
+		// If we hit the cap we can't keep up, so drop what's left
+		// rather than trying to catch up (which would only get worse)
+		if ( m_fAccumulator >= fTimeStep )
+			m_fAccumulator = fmod( m_fAccumulator, fTimeStep );
+	}
 
-		// Get out if there's less than 2
-		if ( m_vRigidBodies.size() < 2 )
-			return;
+	// Move bound drawables to where their bodies are drawn
+	SyncDrawables();
 
-		// Check every one against the other
-		for ( auto itOuter = m_vRigidBodies.begin(); itOuter != m_vRigidBodies.end(); ++itOuter )
-		{
-			for ( auto itInner = itOuter + 1; itInner != m_vRigidBodies.end(); ++itInner )
-			{
-				// Skip if both have negative mass
-				if ( itOuter->fMass < 0 && itInner->fMass < 0 )
-					continue;
+	// Give queries the new positions, if anything is asking
+	m_SpatialQueryCache.Update( m_PhysicsWorld );
+}
 
-				std::list<Contact> liNewContacts = RigidBody2D::GetSpeculativeContacts( &*itOuter, &*itInner );
-				m_liSpeculativeContacts.splice( m_liSpeculativeContacts.end(), liNewContacts );
-			}
+void Scene::Step()
+{
+	m_PhysicsWorld.Step();
+	m_SpatialQueryCache.Invalidate();
+	m_FrameStats.Add( m_PhysicsWorld.GetStats() );
+
+	const std::vector<PhysicsWorld::CollisionEvent>& vEvents = m_PhysicsWorld.GetCollisionEvents();
+	m_vCollisionEvents.insert( m_vCollisionEvents.end(), vEvents.begin(), vEvents.end() );
+
+	// Count collisions between bodies that have IDs (walls and such don't)
+	for ( const PhysicsWorld::CollisionEvent& ev : vEvents )
+	{
+		if ( ev.iIdA < 0 || ev.iIdB < 0 )
+			continue;
+
+		for ( const int iID : { ev.iIdA, ev.iIdB } )
+		{
+			if ( iID >= kMaxCountedID )
+				continue;
 
-			// Increment total energy while we're at it
-			fTotalEnergy += itOuter->GetKineticEnergy();
+			if ( (size_t) iID >= m_vCollisionCounts.size() )
+				m_vCollisionCounts.resize( iID + 1, 0 );
+			m_vCollisionCounts[iID]++;
 		}
+	}
+}
+
+bool Scene::BindDrawable( const size_t rbIdx, const size_t drIdx )
+{
+	if ( rbIdx >= m_PhysicsWorld.GetNumRigidBodies() || drIdx >= m_vDrawables.size() )
+		return false;
+
+	// A drawable follows one body at most
+	UnbindDrawable( drIdx );
+	m_vDrawableBindings.push_back( { (uint32_t) rbIdx, (uint32_t) drIdx } );
+	return true;
+}
+
+bool Scene::UnbindDrawable( const size_t drIdx )
+{
+	auto itBinding = std::find_if( m_vDrawableBindings.begin(), m_vDrawableBindings.end(),
+								   [drIdx] ( const DrawableBinding& b ) { return b.uDrawableIdx == drIdx; } );
+	if ( itBinding == m_vDrawableBindings.end() )
+		return false;
+
+	m_vDrawableBindings.erase( itBinding );
+	return true;
+}
 
-		//std::cout << fTotalEnergy << std::endl;
+void Scene::ClearDrawableBindings()
+{
+	m_vDrawableBindings.clear();
+}
 
-		// Solve contacts
-		m_ContactSolver.Solve( m_liSpeculativeContacts );
+void Scene::SyncDrawables()
+{
+	const float fAlpha = GetInterpolationAlpha();
+	const size_t nRigidBodies = m_PhysicsWorld.GetNumRigidBodies();
+	for ( const DrawableBinding& b : m_vDrawableBindings )
+	{
+		// Loading a snapshot can take bodies away
+		if ( b.uRigidBodyIdx < nRigidBodies )
+			m_vDrawables[b.uDrawableIdx].SetTransform( m_PhysicsWorld.GetInterpolatedQuatVec( b.uRigidBodyIdx, fAlpha ) );
 	}
 }
 
+PhysicsWorld * Scene::GetPhysicsWorld()
+{
+	return &m_PhysicsWorld;
+}
+
+const PhysicsWorld * Scene::GetPhysicsWorld() const
+{
+	return &m_PhysicsWorld;
+}
+
 int Scene::AddDrawable( std::string strIqmFile, vec2 T, vec2 S, vec4 C )
 {
 	Drawable D;
@@ -137,46 +242,187 @@ int Scene::AddDrawable( std::string strIqmFile, vec2 T, vec2 S, vec4 C )
 
 int Scene::AddRigidBody( RigidBody2D::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails )
 {
-	try
-	{
-		RigidBody2D rb;
-		switch ( eType )
-		{
-			case RigidBody2D::EType::Circle:
-			{
-				float fRad = mapDetails.at( "r" );
-				rb = Circle::Create( v2Vel, v2Pos, fMass, fElasticity, fRad );
-				break;
-			}
-			case RigidBody2D::EType::OBB:
-			case RigidBody2D::EType::AABB:
-			{
-				float w = mapDetails.at( "w" );
-				float h = mapDetails.at( "h" );
-				if ( eType == RigidBody2D::EType::AABB )
-				{
-					rb = AABB::Create( v2Vel, v2Pos, fMass, fElasticity, glm::vec2( w, h ) / 2.f );
-				}
-				else
-				{
-					float th = mapDetails.at( "th" );
-					rb = OBB::Create( v2Vel, v2Pos, fMass, fElasticity, glm::vec2( w, h ), th );
-				}
-				break;
-			}
-			default:
-				return -1;
-		}
+	m_SpatialQueryCache.Invalidate();
+	return m_PhysicsWorld.AddRigidBody( eType, v2Vel, v2Pos, fMass, fElasticity, mapDetails );
+}
 
-		m_vRigidBodies.push_back( rb );
-		return m_vRigidBodies.size() - 1;
-	}
-	catch ( std::out_of_range )
-	{
-		std::cerr << "Error! Invalid details provided when creating Rigid Body!" << std::endl;
-	}
+// Turn a flat list of floats into groups of nPerQuery, dropping any partial group at the end
+static std::vector<glm::vec2> getQueryCoords( const std::vector<float>& vCoords, const size_t nPerQuery, const size_t nOffset )
+{
+	std::vector<glm::vec2> v2Coords;
+	v2Coords.reserve( vCoords.size() / nPerQuery );
+	for ( size_t i = 0; i + nPerQuery <= vCoords.size(); i += nPerQuery )
+		v2Coords.emplace_back( vCoords[i + nOffset], vCoords[i + nOffset + 1] );
+	return v2Coords;
+}
+
+std::vector<SpatialQuery::Hit> Scene::QueryPoints( std::vector<float> vCoords, uint32_t uMask ) const
+{
+	std::vector<SpatialQuery::Hit> vHits;
+	if ( std::shared_ptr<const SpatialQuery> pQuery = GetSpatialQuery() )
+		pQuery->QueryPoints( getQueryCoords( vCoords, 2, 0 ), vHits, uMask );
+	return vHits;
+}
+
+std::vector<SpatialQuery::Hit> Scene::QueryBoxes( std::vector<float> vCoords, uint32_t uMask ) const
+{
+	std::vector<SpatialQuery::Hit> vHits;
+	if ( std::shared_ptr<const SpatialQuery> pQuery = GetSpatialQuery() )
+		pQuery->QueryBoxes( getQueryCoords( vCoords, 4, 0 ), getQueryCoords( vCoords, 4, 2 ), vHits, uMask );
+	return vHits;
+}
+
+std::vector<SpatialQuery::Hit> Scene::QueryRays( std::vector<float> vCoords, uint32_t uMask ) const
+{
+	std::vector<float> vLengths;
+	for ( size_t i = 0; i + 5 <= vCoords.size(); i += 5 )
+		vLengths.push_back( vCoords[i + 4] );
+
+	std::vector<SpatialQuery::Hit> vHits;
+	if ( std::shared_ptr<const SpatialQuery> pQuery = GetSpatialQuery() )
+		pQuery->QueryRays( getQueryCoords( vCoords, 5, 0 ), getQueryCoords( vCoords, 5, 2 ), vLengths, vHits, uMask );
+	return vHits;
+}
 
-	return -1;
+std::shared_ptr<const SpatialQuery> Scene::GetSpatialQuery() const
+{
+	return m_SpatialQueryCache.Get();
+}
+
+void Scene::RefreshSpatialQuery()
+{
+	m_SpatialQueryCache.Refresh( m_PhysicsWorld );
+}
+
+size_t Scene::GetNumCandidatePairs() const
+{
+	return m_PhysicsWorld.GetNumCandidatePairs();
+}
+
+size_t Scene::GetNumCulledContacts() const
+{
+	return m_PhysicsWorld.GetNumCulledContacts();
+}
+
+uint32_t Scene::GetSolverIterations() const
+{
+	return m_PhysicsWorld.GetSolverIterations();
+}
+
+size_t Scene::GetNumIslands() const
+{
+	return m_PhysicsWorld.GetNumIslands();
+}
+
+PhysicsWorld::Stats Scene::GetStats() const
+{
+	return m_FrameStats;
+}
+
+void Scene::SetSolverMode( Contact::Solver::EMode eMode )
+{
+	m_PhysicsWorld.SetSolverMode( eMode );
+}
+
+Contact::Solver::EMode Scene::GetSolverMode() const
+{
+	return m_PhysicsWorld.GetSolverMode();
+}
+
+void Scene::SetAllowSleep( bool bAllowSleep )
+{
+	m_PhysicsWorld.SetAllowSleep( bAllowSleep );
+}
+
+bool Scene::GetAllowSleep() const
+{
+	return m_PhysicsWorld.GetAllowSleep();
+}
+
+bool Scene::WakeRigidBody( const size_t rbIdx )
+{
+	return m_PhysicsWorld.WakeRigidBody( rbIdx );
+}
+
+bool Scene::SetCollisionFilter( const size_t rbIdx, const uint32_t uCategory, const uint32_t uMask )
+{
+	m_SpatialQueryCache.Invalidate();
+	return m_PhysicsWorld.SetCollisionFilter( rbIdx, uCategory, uMask );
+}
+
+uint32_t Scene::GetCollisionCategory( const size_t rbIdx ) const
+{
+	const RigidBody2D * pRB = m_PhysicsWorld.GetRigidBody2D( rbIdx );
+	return pRB ? pRB->uCategory : 0;
+}
+
+uint32_t Scene::GetCollisionMask( const size_t rbIdx ) const
+{
+	const RigidBody2D * pRB = m_PhysicsWorld.GetRigidBody2D( rbIdx );
+	return pRB ? pRB->uMask : 0;
+}
+
+void Scene::WakeAll()
+{
+	m_PhysicsWorld.WakeAll();
+}
+
+size_t Scene::GetNumAwakeBodies() const
+{
+	return m_PhysicsWorld.GetNumAwakeBodies();
+}
+
+size_t Scene::GetNumSleepingBodies() const
+{
+	return m_PhysicsWorld.GetNumSleepingBodies();
+}
+
+bool Scene::SetTimeStep( float fDT )
+{
+	return m_PhysicsWorld.SetTimeStep( fDT );
+}
+
+float Scene::GetTimeStep() const
+{
+	return m_PhysicsWorld.GetTimeStep();
+}
+
+void Scene::SetMaxSubsteps( uint32_t uMaxSubsteps )
+{
+	m_uMaxSubsteps = std::max( 1u, uMaxSubsteps );
+}
+
+uint32_t Scene::GetMaxSubsteps() const
+{
+	return m_uMaxSubsteps;
+}
+
+uint32_t Scene::GetNumSubsteps() const
+{
+	return m_uNumSubsteps;
+}
+
+float Scene::GetInterpolationAlpha() const
+{
+	// While paused everything is drawn where it is
+	if ( m_bPauseCollision )
+		return 1.f;
+	return clamp( m_fAccumulator * m_PhysicsWorld.GetInvTimeStep(), 0.f, 1.f );
+}
+
+quatvec Scene::GetInterpolatedQuatVec( const size_t rbIdx ) const
+{
+	return m_PhysicsWorld.GetInterpolatedQuatVec( rbIdx, GetInterpolationAlpha() );
+}
+
+void Scene::SetWarmStartFactor( float fFactor )
+{
+	m_PhysicsWorld.SetWarmStartFactor( fFactor );
+}
+
+float Scene::GetWarmStartFactor() const
+{
+	return m_PhysicsWorld.GetWarmStartFactor();
 }
 
 const SoundManager * Scene::GetSoundManagerPtr() const
@@ -184,6 +430,11 @@ const SoundManager * Scene::GetSoundManagerPtr() const
 	return &m_SoundManager;
 }
 
+const BatchRunner * Scene::GetBatchRunnerPtr() const
+{
+	return &m_BatchRunner;
+}
+
 const Shader * Scene::GetShaderPtr() const
 {
 	return  &m_Shader;
@@ -203,9 +454,7 @@ const Drawable * Scene::GetDrawable( const size_t drIdx ) const
 
 const RigidBody2D * Scene::GetRigidBody2D( const size_t rbIdx ) const
 {
-	if ( rbIdx < m_vRigidBodies.size() )
-		return &m_vRigidBodies[rbIdx];
-	return nullptr;
+	return m_PhysicsWorld.GetRigidBody2D( rbIdx );
 }
 
 void Scene::SetQuitFlag( bool bQuit )
@@ -289,14 +538,81 @@ bool Scene::InitDisplay( std::string strWindowName, uint32_t glMajor, uint32_t g
 	return true;
 }
 
-// This is a dumb function...
 std::list<const Contact *> Scene::GetContacts() const
 {
-	std::list<const Contact *> liRet;
-	std::transform( m_liSpeculativeContacts.begin(), m_liSpeculativeContacts.end(), std::back_inserter( liRet ),
-					[] ( const Contact& c )
-	{
-		return &c;
-	} );
-	return liRet;
-}
\ No newline at end of file
+	return m_PhysicsWorld.GetContacts();
+}
+
+const std::vector<PhysicsWorld::CollisionEvent>& Scene::GetCollisionEvents() const
+{
+	return m_vCollisionEvents;
+}
+
+void Scene::ClearCollisionEvents()
+{
+	m_vCollisionEvents.clear();
+}
+
+void Scene::ResetCollisionCounts()
+{
+	// Keep the storage, the same IDs will probably show up again
+	std::fill( m_vCollisionCounts.begin(), m_vCollisionCounts.end(), 0 );
+}
+
+uint32_t Scene::GetCollisionCount( const int iID ) const
+{
+	if ( iID >= 0 && (size_t) iID < m_vCollisionCounts.size() )
+		return m_vCollisionCounts[iID];
+	return 0;
+}
+
+std::vector<uint32_t> Scene::GetCollisionCounts() const
+{
+	return m_vCollisionCounts;
+}
+
+int Scene::GetMostCollidedID() const
+{
+	// max_element returns the first of equal elements
+	auto itMax = std::max_element( m_vCollisionCounts.begin(), m_vCollisionCounts.end() );
+	if ( itMax == m_vCollisionCounts.end() || *itMax == 0 )
+		return -1;
+
+	return (int) std::distance( m_vCollisionCounts.begin(), itMax );
+}
+
+bool Scene::SaveSnapshot( std::string strFileName ) const
+{
+	std::vector<uint8_t> vData;
+	SnapshotWriter writer( vData );
+	m_PhysicsWorld.SaveSnapshot( writer );
+	m_SoundManager.SaveSnapshot( writer );
+	return WriteSnapshotFile( strFileName, vData );
+}
+
+bool Scene::LoadSnapshot( std::string strFileName )
+{
+	std::vector<uint8_t> vData;
+	if ( ReadSnapshotFile( strFileName, vData ) == false )
+		return false;
+
+	// Check both sections before changing anything, so a bad
+	// sound section can't leave the physics half restored
+	SnapshotReader reader( vData.data(), vData.size() );
+	PhysicsWorld::SnapshotState physicsState;
+	SoundManager::SnapshotState soundState;
+	if ( m_PhysicsWorld.ReadSnapshot( reader, physicsState ) == false || m_SoundManager.ReadSnapshot( reader, soundState ) == false )
+		return false;
+
+	m_PhysicsWorld.ApplySnapshot( physicsState );
+	m_SoundManager.ApplySnapshot( soundState );
+
+	// Start timing over, so the next Update doesn't try to catch up
+	m_bClockStarted = false;
+	m_fAccumulator = 0;
+	m_vCollisionEvents.clear();
+	m_FrameStats = PhysicsWorld::Stats();
+	m_SpatialQueryCache.Invalidate();
+
+	return true;
+}
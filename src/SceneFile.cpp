@@ -0,0 +1,97 @@
+#include "SceneFile.h"
+#include "Util.h"
+
+#include <fstream>
+#include <sstream>
+
+// Parse the shape of a body line and add it, returns false if that went wrong
+static bool addBody( PhysicsWorld& world, const std::string& strType, std::istringstream& issLine, const glm::vec2 v2Offset )
+{
+	glm::vec2 v2Pos, v2Vel;
+	float fMass( 0 ), fElast( 0 );
+	if ( !( issLine >> v2Pos.x >> v2Pos.y >> v2Vel.x >> v2Vel.y >> fMass >> fElast ) )
+		return false;
+
+	RigidBody2D::EType eType;
+	std::map<std::string, float> mapDetails;
+	if ( strType == "circle" )
+	{
+		eType = RigidBody2D::EType::Circle;
+		if ( !( issLine >> mapDetails["r"] ) )
+			return false;
+	}
+	else if ( strType == "aabb" || strType == "obb" )
+	{
+		eType = strType == "aabb" ? RigidBody2D::EType::AABB : RigidBody2D::EType::OBB;
+		if ( !( issLine >> mapDetails["w"] >> mapDetails["h"] ) )
+			return false;
+		if ( eType == RigidBody2D::EType::OBB && !( issLine >> mapDetails["th"] ) )
+			return false;
+	}
+	else
+		return false;
+
+	return world.AddRigidBody( eType, v2Vel, v2Pos + v2Offset, fMass, fElast, mapDetails ) >= 0;
+}
+
+int LoadSceneFile( const std::string& strFileName, PhysicsWorld& world )
+{
+	std::ifstream ifsScene( strFileName );
+	if ( ifsScene.is_open() == false )
+	{
+		std::cerr << "Error! Unable to open scene file " << strFileName << std::endl;
+		return -1;
+	}
+
+	// A grid line applies to the body after it
+	int nGridX( 1 ), nGridY( 1 );
+	glm::vec2 v2GridStep( 0 );
+
+	int nBodies( 0 ), nLine( 0 );
+	std::string strLine;
+	while ( std::getline( ifsScene, strLine ) )
+	{
+		nLine++;
+		std::istringstream issLine( strLine.substr( 0, strLine.find( '#' ) ) );
+		std::string strType;
+		if ( !( issLine >> strType ) )
+			continue;
+
+		bool bOK( true );
+		if ( strType == "timestep" )
+		{
+			float fDT( 0 );
+			bOK = ( issLine >> fDT ) && world.SetTimeStep( fDT );
+		}
+		else if ( strType == "grid" )
+		{
+			bOK = ( issLine >> nGridX >> nGridY >> v2GridStep.x >> v2GridStep.y ) && nGridX > 0 && nGridY > 0;
+		}
+		else
+		{
+			// Every copy reads the same shape, so rewind the stream each time
+			const std::streampos posShape = issLine.tellg();
+			for ( int j = 0; bOK && j < nGridY; j++ )
+			{
+				for ( int i = 0; bOK && i < nGridX; i++ )
+				{
+					issLine.clear();
+					issLine.seekg( posShape );
+					bOK = addBody( world, strType, issLine, glm::vec2( i * v2GridStep.x, j * v2GridStep.y ) );
+					nBodies += bOK ? 1 : 0;
+				}
+			}
+
+			nGridX = nGridY = 1;
+			v2GridStep = glm::vec2( 0 );
+		}
+
+		if ( bOK == false )
+		{
+			std::cerr << "Error! Invalid line " << nLine << " in scene file " << strFileName << std::endl;
+			return -1;
+		}
+	}
+
+	return nBodies;
+}
@@ -0,0 +1,48 @@
+#include "Snapshot.h"
+
+#include <fstream>
+#include <iostream>
+
+SnapshotWriter::SnapshotWriter( std::vector<uint8_t>& vData ) :
+	m_vData( vData )
+{}
+
+SnapshotReader::SnapshotReader( const uint8_t * pData, const size_t uSize ) :
+	m_pCur( pData ),
+	m_pEnd( pData + uSize )
+{}
+
+size_t SnapshotReader::GetRemaining() const
+{
+	return (size_t) ( m_pEnd - m_pCur );
+}
+
+bool WriteSnapshotFile( const std::string& strFileName, const std::vector<uint8_t>& vData )
+{
+	std::ofstream ofsSnapshot( strFileName, std::ios::binary );
+	if ( ofsSnapshot.is_open() == false )
+	{
+		std::cerr << "Error! Unable to open snapshot file " << strFileName << " for writing" << std::endl;
+		return false;
+	}
+
+	ofsSnapshot.write( (const char *) vData.data(), vData.size() );
+	return ofsSnapshot.good();
+}
+
+bool ReadSnapshotFile( const std::string& strFileName, std::vector<uint8_t>& vData )
+{
+	std::ifstream ifsSnapshot( strFileName, std::ios::binary | std::ios::ate );
+	if ( ifsSnapshot.is_open() == false )
+	{
+		std::cerr << "Error! Unable to open snapshot file " << strFileName << std::endl;
+		return false;
+	}
+
+	// We opened at the end, so this is the file size
+	const std::streamoff uSize = ifsSnapshot.tellg();
+	ifsSnapshot.seekg( 0 );
+	vData.resize( (size_t) uSize );
+	ifsSnapshot.read( (char *) vData.data(), uSize );
+	return ifsSnapshot.good();
+}
@@ -7,6 +7,25 @@
 
 #include <iostream>
 #include <algorithm>
+#include <iterator>
+
+// Identifies the sound section of a snapshot, bump the version whenever what's saved changes
+const uint32_t kSnapshotMagic = 0x20444E53;	// "SND "
+const uint32_t kSnapshotVersion = 1;
+
+struct SnapshotHeader
+{
+	uint32_t uMagic;
+	uint32_t uVersion;
+	uint32_t uRecordSize;	// sizeof( Voice::Record ) in the build that saved it
+	uint32_t uNumClips;
+	uint32_t uNumVoices;
+	uint64_t uSamplePos;
+};
+
+// Records are written to disk as they are, so they must have no padding
+// whose bytes would be left uninitialized
+static_assert( sizeof( Voice::Record ) == 4 * sizeof( int32_t ) + 3 * sizeof( uint64_t ) + 2 * sizeof( uint32_t ), "Voice::Record must not have padding" );
 
 SoundManager::SoundManager() :
 	m_bPlaying( false ),
@@ -377,4 +396,120 @@ Clip * SoundManager::GetClip( std::string strClipName ) const
 	if ( itClip != m_mapClips.end() )
 		return (Clip *) &itClip->second;
 	return nullptr;
-}
\ No newline at end of file
+}
+
+void SoundManager::SaveSnapshot( SnapshotWriter& writer ) const
+{
+	// The audio thread owns the voices, keep it out while we look at them
+	SDL_LockAudio();
+
+	std::vector<Voice::Record> vRecords;
+	for ( const Voice& v : m_liVoices )
+	{
+		// Clips are found by their place in the map
+		uint32_t uClipIdx( 0 );
+		for ( auto& itClip : m_mapClips )
+		{
+			if ( &itClip.second == v.GetClip() )
+				break;
+			uClipIdx++;
+		}
+		vRecords.push_back( v.GetRecord( uClipIdx ) );
+	}
+
+	// Zeroed first, the padding before uSamplePos is written too
+	SnapshotHeader header = {};
+	header.uMagic = kSnapshotMagic;
+	header.uVersion = kSnapshotVersion;
+	header.uRecordSize = sizeof( Voice::Record );
+	header.uNumClips = (uint32_t) m_mapClips.size();
+	header.uNumVoices = (uint32_t) vRecords.size();
+	header.uSamplePos = m_uSamplePos;
+
+	SDL_UnlockAudio();
+
+	writer.Write( header );
+	writer.Write( vRecords.data(), vRecords.size() );
+}
+
+SoundManager::SnapshotState::SnapshotState() :
+	uSamplePos( 0 )
+{}
+
+SoundManager::SnapshotState::~SnapshotState()
+{}
+
+bool SoundManager::ReadSnapshot( SnapshotReader& reader, SnapshotState& state ) const
+{
+	SnapshotHeader header;
+	if ( reader.Read( header ) == false || header.uMagic != kSnapshotMagic )
+	{
+		std::cerr << "Error! Snapshot has no sound section" << std::endl;
+		return false;
+	}
+
+	if ( header.uVersion != kSnapshotVersion || header.uRecordSize != sizeof( Voice::Record ) )
+	{
+		std::cerr << "Error! Snapshot sound section is version " << header.uVersion << ", expected " << kSnapshotVersion << std::endl;
+		return false;
+	}
+
+	if ( header.uNumClips != m_mapClips.size() )
+	{
+		std::cerr << "Error! Snapshot was saved with " << header.uNumClips << " clips, but " << m_mapClips.size() << " are registered" << std::endl;
+		return false;
+	}
+
+	if ( header.uNumVoices > reader.GetRemaining() / sizeof( Voice::Record ) )
+	{
+		std::cerr << "Error! Snapshot sound section is damaged" << std::endl;
+		return false;
+	}
+
+	std::vector<Voice::Record> vRecords( header.uNumVoices );
+	reader.Read( vRecords.data(), vRecords.size() );
+
+	// Voices without a clip render nothing, so they're no loss
+	state.liVoices.clear();
+	for ( const Voice::Record& rec : vRecords )
+	{
+		if ( Voice::IsValidRecord( rec ) == false )
+		{
+			std::cerr << "Error! Snapshot holds an invalid voice" << std::endl;
+			return false;
+		}
+
+		if ( rec.uClipIdx < m_mapClips.size() )
+			state.liVoices.emplace_back( rec, &std::next( m_mapClips.begin(), rec.uClipIdx )->second );
+	}
+
+	state.uSamplePos = header.uSamplePos;
+	return true;
+}
+
+void SoundManager::ApplySnapshot( SnapshotState& state )
+{
+	SDL_LockAudio();
+
+	m_liVoices.swap( state.liVoices );
+	m_uSamplePos = (size_t) state.uSamplePos;
+
+	// Commands sent before the load were meant for the old voices
+	m_liAudioCmdQueue.clear();
+	{
+		std::lock_guard<std::mutex> lg( m_muAudioMutex );
+		m_liPublicCmdQueue.remove_if( [] ( const Command& cmd ) { return cmd.eID != ECommandID::BufCompleted; } );
+	}
+
+	SDL_UnlockAudio();
+}
+
+bool SoundManager::LoadSnapshot( SnapshotReader& reader )
+{
+	SnapshotState state;
+	if ( ReadSnapshot( reader, state ) == false )
+		return false;
+
+	ApplySnapshot( state );
+	return true;
+}
@@ -0,0 +1,280 @@
+#include "SpatialQuery.h"
+#include "Util.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+// Bodies at least this many times wider than the median are kept off to the
+// side and always tested, so that a long wall doesn't widen every x search
+const float kWideFactor = 8.f;
+
+// Is p inside (or on) the body
+static bool isPointInside( const RigidBody2D& rb, const glm::vec2 p )
+{
+	const glm::vec2 d = p - rb.GetCenter();
+	if ( rb.eType == RigidBody2D::EType::Circle )
+		return glm::dot( d, d ) <= rb.circData.fRadius * rb.circData.fRadius;
+
+	// Into the box's frame (AABBs have the identity)
+	const glm::vec2& R = rb.boxData.v2HalfDim;
+	return fabs( glm::dot( d, rb.boxData.m2Rot[0] ) ) <= R.x && fabs( glm::dot( d, rb.boxData.m2Rot[1] ) ) <= R.y;
+}
+
+// Does the body touch the box [v2Min, v2Max], given that their bounds overlap
+static bool isOverlappingBox( const RigidBody2D& rb, const glm::vec2 v2Min, const glm::vec2 v2Max )
+{
+	if ( rb.eType == RigidBody2D::EType::Circle )
+	{
+		const glm::vec2 d = rb.GetCenter() - glm::clamp( rb.GetCenter(), v2Min, v2Max );
+		return glm::dot( d, d ) <= rb.circData.fRadius * rb.circData.fRadius;
+	}
+
+	// The bounds of an AABB are the AABB
+	if ( rb.eType != RigidBody2D::EType::OBB )
+		return true;
+
+	// The world axes were covered by the bounds, so only the OBB's are left
+	const glm::vec2 v2BoxCenter = 0.5f * ( v2Min + v2Max );
+	const glm::vec2 v2BoxHalfDim = 0.5f * ( v2Max - v2Min );
+	for ( int i = 0; i < 2; i++ )
+	{
+		const glm::vec2& n = rb.boxData.m2Rot[i];
+		const float fBoxRadius = v2BoxHalfDim.x * fabs( n.x ) + v2BoxHalfDim.y * fabs( n.y );
+		if ( fabs( glm::dot( v2BoxCenter - rb.GetCenter(), n ) ) > fBoxRadius + rb.boxData.v2HalfDim[i] )
+			return false;
+	}
+
+	return true;
+}
+
+// Where along the ray (unit direction) the body is first hit, or a negative number if it isn't
+static float rayCast( const RigidBody2D& rb, const glm::vec2 v2Origin, const glm::vec2 v2Dir, const float fLength )
+{
+	const glm::vec2 m = v2Origin - rb.GetCenter();
+	if ( rb.eType == RigidBody2D::EType::Circle )
+	{
+		// Solve |m + t d|^2 = r^2 for the smaller t
+		const float b = glm::dot( m, v2Dir );
+		const float c = glm::dot( m, m ) - rb.circData.fRadius * rb.circData.fRadius;
+		if ( c <= 0 )
+			return 0.f;
+		if ( b > 0 )
+			return -1.f;
+
+		const float fDisc = b * b - c;
+		if ( fDisc < 0 )
+			return -1.f;
+
+		const float t = -b - sqrtf( fDisc );
+		return t <= fLength ? t : -1.f;
+	}
+
+	// Clip the ray against the slabs of the box, in the box's frame
+	float fEnter( 0 ), fExit( fLength );
+	for ( int i = 0; i < 2; i++ )
+	{
+		const glm::vec2& n = rb.boxData.m2Rot[i];
+		const float o = glm::dot( m, n );
+		const float d = glm::dot( v2Dir, n );
+		const float R = rb.boxData.v2HalfDim[i];
+		if ( d == 0 )
+		{
+			// Parallel to the slab, so it's either always in it or never
+			if ( fabs( o ) > R )
+				return -1.f;
+			continue;
+		}
+
+		float t1 = ( -R - o ) / d;
+		float t2 = ( R - o ) / d;
+		if ( t1 > t2 )
+			std::swap( t1, t2 );
+
+		fEnter = std::max( fEnter, t1 );
+		fExit = std::min( fExit, t2 );
+		if ( fEnter > fExit )
+			return -1.f;
+	}
+
+	return fEnter;
+}
+
+SpatialQuery::SpatialQuery( const std::vector<RigidBody2D>& vRigidBodies, const std::vector<uint32_t>& vOrder ) :
+	m_vRigidBodies( vRigidBodies ),
+	m_fMaxWidth( 0 )
+{
+	const size_t nBodies = m_vRigidBodies.size();
+	m_vMin.resize( nBodies );
+	m_vMax.resize( nBodies );
+	std::vector<float> vWidths( nBodies );
+	for ( size_t i = 0; i < nBodies; i++ )
+	{
+		const RigidBody2D& rb = m_vRigidBodies[i];
+		const glm::vec2 v2HalfDim = rb.GetBoundingHalfDim();
+		m_vMin[i] = rb.GetCenter() - v2HalfDim;
+		m_vMax[i] = rb.GetCenter() + v2HalfDim;
+		vWidths[i] = 2.f * v2HalfDim.x;
+	}
+
+	// Anything much wider than the median goes on the wide list
+	float fMedianWidth( 0 );
+	if ( nBodies > 0 )
+	{
+		std::vector<float> vSortedWidths( vWidths );
+		std::nth_element( vSortedWidths.begin(), vSortedWidths.begin() + nBodies / 2, vSortedWidths.end() );
+		fMedianWidth = vSortedWidths[nBodies / 2];
+	}
+	auto isWide = [&] ( const uint32_t uIdx )
+	{
+		return vWidths[uIdx] > kWideFactor * fMedianWidth;
+	};
+
+	// Start with the broadphase's order, then add whatever it didn't know about
+	std::vector<bool> vSeen( nBodies, false );
+	for ( const uint32_t uIdx : vOrder )
+	{
+		if ( uIdx >= nBodies || vSeen[uIdx] )
+			continue;
+
+		vSeen[uIdx] = true;
+		( isWide( uIdx ) ? m_vWide : m_vSorted ).push_back( uIdx );
+	}
+
+	const bool bSeeded = m_vSorted.size() + m_vWide.size() == nBodies;
+	for ( uint32_t uIdx = 0; uIdx < (uint32_t) nBodies; uIdx++ )
+	{
+		if ( vSeen[uIdx] == false )
+			( isWide( uIdx ) ? m_vWide : m_vSorted ).push_back( uIdx );
+	}
+
+	// The broadphase order used padded bounds from before the last solve, so it's only
+	// nearly right and an insertion sort fixes it up quickly. Without it, sort properly
+	auto fnLess = [this] ( const uint32_t a, const uint32_t b )
+	{
+		return m_vMin[a].x < m_vMin[b].x;
+	};
+	if ( bSeeded )
+	{
+		for ( size_t i = 1; i < m_vSorted.size(); i++ )
+		{
+			const uint32_t uIdx = m_vSorted[i];
+			size_t j = i;
+			for ( ; j > 0 && fnLess( uIdx, m_vSorted[j - 1] ); j-- )
+				m_vSorted[j] = m_vSorted[j - 1];
+			m_vSorted[j] = uIdx;
+		}
+	}
+	else
+		std::sort( m_vSorted.begin(), m_vSorted.end(), fnLess );
+
+	m_vSortedMinX.reserve( m_vSorted.size() );
+	for ( const uint32_t uIdx : m_vSorted )
+	{
+		m_vSortedMinX.push_back( m_vMin[uIdx].x );
+		m_fMaxWidth = std::max( m_fMaxWidth, vWidths[uIdx] );
+	}
+}
+
+template <typename F>
+void SpatialQuery::forEachCandidate( const glm::vec2 v2Min, const glm::vec2 v2Max, const uint32_t uMask, F fnVisit ) const
+{
+	auto fnVisitIfOverlapping = [&] ( const uint32_t uIdx )
+	{
+		if ( ( m_vRigidBodies[uIdx].uCategory & uMask ) == 0 )
+			return;
+		if ( m_vMax[uIdx].x < v2Min.x || m_vMin[uIdx].x > v2Max.x || m_vMax[uIdx].y < v2Min.y || m_vMin[uIdx].y > v2Max.y )
+			return;
+		fnVisit( uIdx );
+	};
+
+	// A body can only reach the query if its lower x bound
+	// is within the widest body's width of the query's
+	auto itBegin = std::lower_bound( m_vSortedMinX.begin(), m_vSortedMinX.end(), v2Min.x - m_fMaxWidth );
+	auto itEnd = std::upper_bound( itBegin, m_vSortedMinX.end(), v2Max.x );
+	for ( auto it = itBegin; it != itEnd; ++it )
+		fnVisitIfOverlapping( m_vSorted[it - m_vSortedMinX.begin()] );
+
+	for ( const uint32_t uIdx : m_vWide )
+		fnVisitIfOverlapping( uIdx );
+}
+
+size_t SpatialQuery::QueryPoints( const std::vector<glm::vec2>& vPoints, std::vector<Hit>& vHits, const uint32_t uMask /*= ~0u*/ ) const
+{
+	const size_t nPrevHits = vHits.size();
+	for ( uint32_t q = 0; q < (uint32_t) vPoints.size(); q++ )
+	{
+		const glm::vec2 p = vPoints[q];
+		const size_t nFirstHit = vHits.size();
+		forEachCandidate( p, p, uMask, [&] ( const uint32_t uIdx )
+		{
+			if ( isPointInside( m_vRigidBodies[uIdx], p ) )
+				vHits.push_back( { q, uIdx, m_vRigidBodies[uIdx].GetID(), 0.f } );
+		} );
+
+		// Candidates come out in x order, body order is easier to use
+		std::sort( vHits.begin() + nFirstHit, vHits.end(), [] ( const Hit& a, const Hit& b ) { return a.uBodyIdx < b.uBodyIdx; } );
+	}
+
+	return vHits.size() - nPrevHits;
+}
+
+size_t SpatialQuery::QueryBoxes( const std::vector<glm::vec2>& vMin, const std::vector<glm::vec2>& vMax, std::vector<Hit>& vHits, const uint32_t uMask /*= ~0u*/ ) const
+{
+	const size_t nPrevHits = vHits.size();
+	const uint32_t nQueries = (uint32_t) std::min( vMin.size(), vMax.size() );
+	for ( uint32_t q = 0; q < nQueries; q++ )
+	{
+		// Let the corners come in any order
+		const glm::vec2 v2Min = glm::min( vMin[q], vMax[q] );
+		const glm::vec2 v2Max = glm::max( vMin[q], vMax[q] );
+		const size_t nFirstHit = vHits.size();
+		forEachCandidate( v2Min, v2Max, uMask, [&] ( const uint32_t uIdx )
+		{
+			if ( isOverlappingBox( m_vRigidBodies[uIdx], v2Min, v2Max ) )
+				vHits.push_back( { q, uIdx, m_vRigidBodies[uIdx].GetID(), 0.f } );
+		} );
+
+		std::sort( vHits.begin() + nFirstHit, vHits.end(), [] ( const Hit& a, const Hit& b ) { return a.uBodyIdx < b.uBodyIdx; } );
+	}
+
+	return vHits.size() - nPrevHits;
+}
+
+size_t SpatialQuery::QueryRays( const std::vector<glm::vec2>& vOrigins, const std::vector<glm::vec2>& vDirs, const std::vector<float>& vLengths, std::vector<Hit>& vHits, const uint32_t uMask /*= ~0u*/ ) const
+{
+	const size_t nPrevHits = vHits.size();
+	const uint32_t nQueries = (uint32_t) std::min( { vOrigins.size(), vDirs.size(), vLengths.size() } );
+	for ( uint32_t q = 0; q < nQueries; q++ )
+	{
+		// Rays that don't go anywhere (or go forever) don't hit anything
+		const float fDirLength = glm::length( vDirs[q] );
+		const float fLength = vLengths[q];
+		if ( fDirLength < kEPS || std::isfinite( fDirLength ) == false || fLength < 0 || std::isfinite( fLength ) == false )
+			continue;
+
+		const glm::vec2 v2Origin = vOrigins[q];
+		const glm::vec2 v2Dir = vDirs[q] / fDirLength;
+		const glm::vec2 v2End = v2Origin + fLength * v2Dir;
+		const size_t nFirstHit = vHits.size();
+		forEachCandidate( glm::min( v2Origin, v2End ), glm::max( v2Origin, v2End ), uMask, [&] ( const uint32_t uIdx )
+		{
+			const float t = rayCast( m_vRigidBodies[uIdx], v2Origin, v2Dir, fLength );
+			if ( t >= 0 )
+				vHits.push_back( { q, uIdx, m_vRigidBodies[uIdx].GetID(), t } );
+		} );
+
+		// Nearest first, then by body
+		std::sort( vHits.begin() + nFirstHit, vHits.end(), [] ( const Hit& a, const Hit& b )
+		{
+			return a.fT < b.fT || ( a.fT == b.fT && a.uBodyIdx < b.uBodyIdx );
+		} );
+	}
+
+	return vHits.size() - nPrevHits;
+}
+
+size_t SpatialQuery::GetNumRigidBodies() const
+{
+	return m_vRigidBodies.size();
+}
@@ -0,0 +1,53 @@
+#include "SpatialQueryCache.h"
+#include "PhysicsWorld.h"
+
+SpatialQueryCache::SpatialQueryCache() :
+	m_bStale( true ),
+	m_bUsed( false )
+{}
+
+void SpatialQueryCache::Invalidate()
+{
+	m_bStale = true;
+}
+
+bool SpatialQueryCache::IsStale() const
+{
+	return m_bStale;
+}
+
+void SpatialQueryCache::Update( const PhysicsWorld& world )
+{
+	if ( m_bStale == false )
+		return;
+
+	// Nobody looked at the last copy, so keep it rather than pay for a new one.
+	// Whoever asks next gets it, and the next Update replaces it
+	bool bHaveQuery( false );
+	{
+		std::lock_guard<std::mutex> lg( m_muQuery );
+		bHaveQuery = m_pQuery != nullptr;
+	}
+	if ( m_bUsed.exchange( false ) || bHaveQuery == false )
+		Refresh( world );
+}
+
+void SpatialQueryCache::Refresh( const PhysicsWorld& world )
+{
+	// Copy outside the lock, so queries only ever wait on the swap
+	// (the old copy is freed outside it too, when pQuery goes)
+	std::shared_ptr<const SpatialQuery> pQuery = world.MakeSpatialQuery();
+	{
+		std::lock_guard<std::mutex> lg( m_muQuery );
+		m_pQuery.swap( pQuery );
+	}
+	m_bUsed = false;
+	m_bStale = false;
+}
+
+std::shared_ptr<const SpatialQuery> SpatialQueryCache::Get() const
+{
+	m_bUsed = true;
+	std::lock_guard<std::mutex> lg( m_muQuery );
+	return m_pQuery;
+}
@@ -0,0 +1,159 @@
+#include "SweepAndPrune.h"
+#include "Glm_Util.h"
+#include "Util.h"
+
+#include <glm/gtx/norm.hpp>
+#include <algorithm>
+
+SweepAndPrune::SweepAndPrune() :
+	m_fMargin( g_fSpeculativeMargin )
+{}
+
+void SweepAndPrune::updateBounds( const std::vector<RigidBody2D>& vRigidBodies, const float fDT )
+{
+	m_vMin.resize( vRigidBodies.size() );
+	m_vMax.resize( vRigidBodies.size() );
+
+	for ( size_t i = 0; i < vRigidBodies.size(); i++ )
+	{
+		const RigidBody2D& rb = vRigidBodies[i];
+
+		// Pad the body's bounds by how far it could travel during the step,
+		// including how far its corners could swing if it's rotating, so that
+		// speculative contacts between approaching bodies aren't missed
+		vec2 v2HalfDim = rb.GetBoundingHalfDim();
+		float fPad = m_fMargin;
+		if ( rb.fMass > 0 )
+		{
+			fPad += fDT * glm::length( rb.GetVel() );
+			if ( rb.eType == RigidBody2D::EType::OBB )
+				fPad += fDT * fabs( rb.GetOmega() ) * glm::length( rb.boxData.v2HalfDim );
+		}
+
+		m_vMin[i] = rb.GetCenter() - v2HalfDim - vec2( fPad );
+		m_vMax[i] = rb.GetCenter() + v2HalfDim + vec2( fPad );
+	}
+
+	// If bodies were removed, start over
+	if ( m_vEndpoints.size() > 2 * vRigidBodies.size() )
+		m_vEndpoints.clear();
+
+	// Add endpoints for any new bodies, the sort will take care of them
+	for ( uint32_t i = (uint32_t) m_vEndpoints.size() / 2; i < (uint32_t) vRigidBodies.size(); i++ )
+	{
+		m_vEndpoints.push_back( { 0.f, i << 1 } );
+		m_vEndpoints.push_back( { 0.f, ( i << 1 ) | 1 } );
+	}
+
+	// Refresh endpoint values from the bounds
+	for ( Endpoint& ep : m_vEndpoints )
+	{
+		const uint32_t uIdx = ep.uData >> 1;
+		ep.fValue = ( ep.uData & 1 ) ? m_vMax[uIdx].x : m_vMin[uIdx].x;
+	}
+}
+
+void SweepAndPrune::sortEndpoints()
+{
+	// Insertion sort, the endpoints were sorted last frame
+	// so this is close to linear unless things are moving a lot.
+	// If two values are equal the min end comes first, so that
+	// touching intervals are considered overlapping
+	auto fnLess = [] ( const Endpoint& a, const Endpoint& b )
+	{
+		return a.fValue < b.fValue || ( a.fValue == b.fValue && ( a.uData & 1 ) < ( b.uData & 1 ) );
+	};
+
+	for ( size_t i = 1; i < m_vEndpoints.size(); i++ )
+	{
+		Endpoint ep = m_vEndpoints[i];
+		size_t j = i;
+		for ( ; j > 0 && fnLess( ep, m_vEndpoints[j - 1] ); j-- )
+			m_vEndpoints[j] = m_vEndpoints[j - 1];
+		m_vEndpoints[j] = ep;
+	}
+}
+
+void SweepAndPrune::Clear()
+{
+	m_vEndpoints.clear();
+	m_vPairs.clear();
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::FindPairs( const std::vector<RigidBody2D>& vRigidBodies, const float fDT )
+{
+	m_vPairs.clear();
+	m_vActive.clear();
+
+	updateBounds( vRigidBodies, fDT );
+	sortEndpoints();
+
+	// Sweep along x, keeping track of which intervals are open
+	for ( const Endpoint& ep : m_vEndpoints )
+	{
+		const uint32_t uIdx = ep.uData >> 1;
+
+		// If this is the end of an interval, remove it from the active list
+		if ( ep.uData & 1 )
+		{
+			auto it = std::find( m_vActive.begin(), m_vActive.end(), uIdx );
+			*it = m_vActive.back();
+			m_vActive.pop_back();
+			continue;
+		}
+
+		// Otherwise this body overlaps everything active in x, check y
+		for ( const uint32_t uOther : m_vActive )
+		{
+			// Skip if both have negative mass, or their layers don't collide
+			const RigidBody2D& rbA = vRigidBodies[uIdx];
+			const RigidBody2D& rbB = vRigidBodies[uOther];
+			if ( ( rbA.fMass < 0 && rbB.fMass < 0 ) || RigidBody2D::ShouldCollide( rbA, rbB ) == false )
+				continue;
+
+			if ( m_vMax[uIdx].y < m_vMin[uOther].y || m_vMin[uIdx].y > m_vMax[uOther].y )
+				continue;
+
+			// Keep the lower index first, like the old nested loop did
+			if ( uIdx < uOther )
+				m_vPairs.push_back( { uIdx, uOther } );
+			else
+				m_vPairs.push_back( { uOther, uIdx } );
+		}
+
+		m_vActive.push_back( uIdx );
+	}
+
+	return m_vPairs;
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::GetPairs() const
+{
+	return m_vPairs;
+}
+
+size_t SweepAndPrune::GetNumCandidatePairs() const
+{
+	return m_vPairs.size();
+}
+
+void SweepAndPrune::GetOrderByMinX( std::vector<uint32_t>& vOrder ) const
+{
+	vOrder.clear();
+	vOrder.reserve( m_vEndpoints.size() / 2 );
+	for ( const Endpoint& ep : m_vEndpoints )
+	{
+		if ( ( ep.uData & 1 ) == 0 )
+			vOrder.push_back( ep.uData >> 1 );
+	}
+}
+
+void SweepAndPrune::SetMargin( const float fMargin )
+{
+	m_fMargin = fMargin;
+}
+
+float SweepAndPrune::GetMargin() const
+{
+	return m_fMargin;
+}
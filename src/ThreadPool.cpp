@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool( size_t nThreads /*= 0*/ ) :
+	m_pTask( nullptr ),
+	m_nTasks( 0 ),
+	m_uNextTask( 0 ),
+	m_nBusyWorkers( 0 ),
+	m_uJobID( 0 ),
+	m_bQuit( false )
+{
+	if ( nThreads == 0 )
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+
+	// The caller counts as one of the threads
+	for ( size_t i = 1; i < nThreads; i++ )
+		m_vWorkers.emplace_back( &ThreadPool::workerLoop, this );
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lg( m_muJob );
+		m_bQuit = true;
+	}
+	m_cvStart.notify_all();
+
+	for ( std::thread& t : m_vWorkers )
+		t.join();
+}
+
+size_t ThreadPool::GetNumThreads() const
+{
+	return m_vWorkers.size() + 1;
+}
+
+void ThreadPool::runTasks( const std::function<void( size_t )>& fnTask, const size_t nTasks )
+{
+	// Grab tasks until they're all gone
+	for ( size_t i = m_uNextTask++; i < nTasks; i = m_uNextTask++ )
+		fnTask( i );
+}
+
+void ThreadPool::ParallelFor( size_t nTasks, const std::function<void( size_t )>& fnTask )
+{
+	// Don't bother waking anyone up for one task
+	if ( m_vWorkers.empty() || nTasks < 2 )
+	{
+		for ( size_t i = 0; i < nTasks; i++ )
+			fnTask( i );
+		return;
+	}
+
+	// Post the job
+	{
+		std::lock_guard<std::mutex> lg( m_muJob );
+		m_pTask = &fnTask;
+		m_nTasks = nTasks;
+		m_uNextTask = 0;
+		m_nBusyWorkers = m_vWorkers.size();
+		m_uJobID++;
+	}
+	m_cvStart.notify_all();
+
+	// Help out
+	runTasks( fnTask, nTasks );
+
+	// Wait for the workers to finish whatever they grabbed
+	std::unique_lock<std::mutex> ul( m_muJob );
+	m_cvDone.wait( ul, [this] () { return m_nBusyWorkers == 0; } );
+	m_pTask = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+	uint64_t uLastJobID( 0 );
+	while ( true )
+	{
+		// Wait for a new job (or to be told to quit)
+		const std::function<void( size_t )> * pTask( nullptr );
+		size_t nTasks( 0 );
+		{
+			std::unique_lock<std::mutex> ul( m_muJob );
+			m_cvStart.wait( ul, [this, uLastJobID] () { return m_bQuit || m_uJobID != uLastJobID; } );
+			if ( m_bQuit )
+				return;
+
+			uLastJobID = m_uJobID;
+			pTask = m_pTask;
+			nTasks = m_nTasks;
+		}
+
+		runTasks( *pTask, nTasks );
+
+		// Let the caller know we're done
+		std::lock_guard<std::mutex> lg( m_muJob );
+		if ( --m_nBusyWorkers == 0 )
+			m_cvDone.notify_one();
+	}
+}
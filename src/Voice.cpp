@@ -3,6 +3,7 @@
 #include "Util.h"
 
 #include <algorithm>
+#include <cmath>
 
 // Initializing constructor
 Voice::Voice() :
@@ -53,6 +54,28 @@ Voice::Voice ( const SoundManager::Command cmd ) :
 	}
 }
 
+// Construct from a snapshot record
+Voice::Voice( const Record& rec, const Clip * pClip ) :
+	m_iUniqueID( rec.iUniqueID ),
+	m_eState( (EState) rec.iState ),
+	m_ePrevState( (EState) rec.iPrevState ),
+	m_fVolume( rec.fVolume ),
+	m_uTriggerRes( (size_t) rec.uTriggerRes ),
+	m_uStartingPos( (size_t) rec.uStartingPos ),
+	m_uLastTailSampleAdded( (size_t) rec.uLastTailSampleAdded ),
+	m_pClip( pClip )
+{
+}
+
+/*static*/ bool Voice::IsValidRecord( const Record& rec )
+{
+	auto isState = [] ( const int32_t iState )
+	{
+		return iState >= (int32_t) EState::Pending && iState <= (int32_t) EState::Stopped;
+	};
+	return isState( rec.iState ) && isState( rec.iPrevState ) && std::isfinite( rec.fVolume );
+}
+
 Voice::EState Voice::GetState() const
 {
 	return m_eState;
@@ -73,6 +96,26 @@ int Voice::GetID() const
 	return m_iUniqueID;
 }
 
+const Clip * Voice::GetClip() const
+{
+	return m_pClip;
+}
+
+Voice::Record Voice::GetRecord( const uint32_t uClipIdx ) const
+{
+	Record rec = {};
+	rec.iUniqueID = m_iUniqueID;
+	rec.iState = (int32_t) m_eState;
+	rec.iPrevState = (int32_t) m_ePrevState;
+	rec.fVolume = m_fVolume;
+	rec.uTriggerRes = m_uTriggerRes;
+	rec.uStartingPos = m_uStartingPos;
+	rec.uLastTailSampleAdded = m_uLastTailSampleAdded;
+	rec.uClipIdx = uClipIdx;
+	rec.uPad = 0;
+	return rec;
+}
+
 // Handle the transition to stopping appropriately
 void Voice::SetStopping( const size_t uTriggerRes )
 {
@@ -0,0 +1,77 @@
+// Checks that the copy spatial queries run against survives frames in which
+// nothing queried it, the way Scene::Update drives a SpatialQueryCache
+//
+//	spatialQueryTest
+
+#include "PhysicsWorld.h"
+#include "SpatialQueryCache.h"
+
+#include <iostream>
+#include <vector>
+
+// The number of checks that failed
+int g_nFailures = 0;
+
+void Check( const bool bPassed, const char * szWhat )
+{
+	if ( bPassed == false )
+	{
+		std::cerr << "FAILED: " << szWhat << std::endl;
+		g_nFailures++;
+	}
+}
+
+// Step the world and update the cache, like one Scene::Update that runs a step
+void Frame( PhysicsWorld& world, SpatialQueryCache& cache )
+{
+	world.Step();
+	cache.Invalidate();
+	cache.Update( world );
+}
+
+// Does a point query at the body's center find it
+bool QueryFindsBody( const SpatialQueryCache& cache, const PhysicsWorld& world, const uint32_t uBodyIdx )
+{
+	std::shared_ptr<const SpatialQuery> pQuery = cache.Get();
+	if ( pQuery == nullptr )
+		return false;
+
+	std::vector<SpatialQuery::Hit> vHits;
+	pQuery->QueryPoints( { world.GetRigidBody2D( uBodyIdx )->GetCenter() }, vHits );
+	for ( const SpatialQuery::Hit& hit : vHits )
+		if ( hit.uBodyIdx == uBodyIdx )
+			return true;
+	return false;
+}
+
+int main()
+{
+	PhysicsWorld world( 1 );
+	SpatialQueryCache cache;
+
+	// A resting circle and a wall well away from it
+	const int iCircle = world.AddRigidBody( RigidBody2D::EType::Circle, glm::vec2( 0 ), glm::vec2( 0 ), 1.f, 1.f, { { "r", 1.f } } );
+	world.AddRigidBody( RigidBody2D::EType::AABB, glm::vec2( 0 ), glm::vec2( 10, 0 ), -1.f, 1.f, { { "w", 1.f }, { "h", 10.f } } );
+	cache.Invalidate();
+	Check( iCircle >= 0, "adding the circle" );
+
+	// Nothing has queried yet, the first query still has to find the body
+	Frame( world, cache );
+	Check( QueryFindsBody( cache, world, iCircle ), "query after a frame with no queries" );
+
+	// Two frames with no queries in between, then a query
+	Frame( world, cache );
+	Frame( world, cache );
+	Check( cache.IsStale(), "copy is stale after frames with no queries" );
+	Check( QueryFindsBody( cache, world, iCircle ), "query after idle frames" );
+
+	// That query was noticed, so the next frame takes a new copy
+	std::shared_ptr<const SpatialQuery> pOld = cache.Get();
+	Frame( world, cache );
+	Check( cache.IsStale() == false && cache.Get() != pOld, "copy refreshed after being queried" );
+	Check( QueryFindsBody( cache, world, iCircle ), "query after the refresh" );
+
+	if ( g_nFailures == 0 )
+		std::cout << "All spatial query checks passed" << std::endl;
+	return g_nFailures == 0 ? 0 : 1;
+}